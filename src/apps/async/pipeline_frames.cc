@@ -0,0 +1,215 @@
+/*
+ * Pipeline benchmark: decode, handle and encode on one thread or three.
+ *
+ * usage: pipeline_frames [FRAMES] [DECODE_CPU] [HANDLE_CPU] [ENCODE_CPU]
+ *
+ * Frames are COBS-decoded from a receive buffer, run through a (CPU-bound)
+ * handler and COBS-encoded into a transmit buffer. This is done inline with
+ * callbacks on one thread, then with each step as a pipeline stage (pinned
+ * to the given CPUs, if any). Reports frames/s for both.
+ */
+
+/* internal */
+#include "async/Pipeline.h"
+#include "buffer/PcBuffer.h"
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Coral;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr std::size_t mtu = 256;
+static constexpr std::size_t payload = 128;
+static constexpr std::size_t frames_per_batch = 8;
+
+using Buffer = PcBuffer<mtu * frames_per_batch * 2, uint8_t>;
+using Ring = SpscRing<Frame<mtu>, default_stage_depth>;
+
+/* Stand-in for protocol handling (echoes the frame). */
+static bool handle(const uint8_t *data, std::size_t size, Frame<mtu> &out)
+{
+    uint32_t hash = 2166136261u;
+    for (int round = 0; round < 16; round++)
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+    }
+
+    std::copy_n(data, size, out.data.begin());
+    out.size = size;
+
+    /* Keep the hash from being optimized out. */
+    return hash != 0 or size;
+}
+
+/* Stand-in for transmitting. */
+static void drain(Buffer &buffer)
+{
+    std::size_t count = buffer.state.data_available();
+    if (count)
+    {
+        buffer.pop_n(nullptr, count);
+    }
+}
+
+/* Feeds batches of encoded frames into a buffer (up to a total). */
+struct Source
+{
+    Source(Buffer &_buffer, const std::vector<uint8_t> &_batch,
+           std::size_t frames)
+        : buffer(_buffer), batch(_batch), position(0),
+          batches(frames / frames_per_batch)
+    {
+    }
+
+    void operator()(void)
+    {
+        while (batches)
+        {
+            position += buffer.try_push_n(batch.data() + position,
+                                          batch.size() - position);
+            if (position < batch.size())
+            {
+                break;
+            }
+            position = 0;
+            batches--;
+        }
+    }
+
+    Buffer &buffer;
+    const std::vector<uint8_t> &batch;
+    std::size_t position;
+    std::size_t batches;
+};
+
+static double run_inline(std::size_t frames, const std::vector<uint8_t> &batch)
+{
+    Buffer rx;
+    Buffer tx;
+    Source source(rx, batch, frames);
+
+    std::size_t handled = 0;
+    Frame<mtu> out;
+    Cobs::MessageDecoder<mtu> decoder(
+        [&](const std::array<uint8_t, mtu> &data, std::size_t size) {
+            handle(data.data(), size, out);
+
+            Cobs::MessageEncoder encoder(out.data.data(), out.size);
+            while (not encoder.encode(tx))
+            {
+                drain(tx);
+            }
+            handled++;
+        });
+
+    auto start = Clock::now();
+
+    while (handled < frames)
+    {
+        source();
+        decoder.dispatch(rx);
+        drain(tx);
+    }
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return handled / elapsed.count();
+}
+
+static double run_pipeline(std::size_t frames,
+                           const std::vector<uint8_t> &batch,
+                           const std::array<int, 3> &cpus)
+{
+    Buffer rx;
+    Buffer tx;
+    Ring decoded;
+    Ring handled;
+
+    Source source(rx, batch, frames);
+    DecodeStage decode(rx, decoded, [&source]() { source(); });
+
+    std::atomic<std::size_t> count = 0;
+    HandlerStage<Frame<mtu>, Frame<mtu>> handler(
+        decoded, handled, [&count](const Frame<mtu> &in, Frame<mtu> &out) {
+            count++;
+            return handle(in.data.data(), in.size, out);
+        });
+
+    EncodeStage encode(handled, tx, [&tx]() { drain(tx); });
+
+    auto start = Clock::now();
+
+    Pipeline pipeline;
+    pipeline.add(decode, cpus[0]);
+    pipeline.add(handler, cpus[1]);
+    pipeline.add(encode, cpus[2]);
+
+    while (count < frames)
+    {
+        std::this_thread::yield();
+    }
+    pipeline.stop();
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    for (std::size_t i = 0; i < pipeline.size(); i++)
+    {
+        uint32_t steps;
+        uint32_t idle;
+        pipeline[i].poll_metrics(steps, idle);
+        std::cout << "  stage " << i << ": steps: " << steps
+                  << ", idle: " << idle
+                  << ", pinned: " << pipeline[i].pinned() << std::endl;
+    }
+
+    return count / elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t frames = (argc > 1) ? std::atol(argv[1]) : 200000;
+    std::array<int, 3> cpus;
+    for (std::size_t i = 0; i < cpus.size(); i++)
+    {
+        cpus[i] = (argc > 2 + (int)i) ? std::atoi(argv[2 + i])
+                                      : StageThread::any_cpu;
+    }
+
+    /* Only whole batches are delivered. */
+    frames -= frames % frames_per_batch;
+
+    std::vector<uint8_t> frame(payload);
+    for (std::size_t i = 0; i < payload; i++)
+    {
+        frame[i] = i;
+    }
+
+    Buffer encoded;
+    for (std::size_t i = 0; i < frames_per_batch; i++)
+    {
+        Cobs::MessageEncoder encoder(frame.data(), frame.size());
+        encoder.encode(encoded);
+    }
+    std::vector<uint8_t> batch(encoded.state.data_available());
+    encoded.pop_n(batch.data(), batch.size());
+
+    double inline_rate = run_inline(frames, batch);
+    std::cout << "inline frames/s: " << inline_rate << std::endl;
+
+    double pipeline_rate = run_pipeline(frames, batch, cpus);
+    std::cout << "pipeline frames/s: " << pipeline_rate << " ("
+              << pipeline_rate / inline_rate << "x)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Work-stealing pool benchmark: many links with skewed traffic.
+ *
+ * usage: pool_links [LINKS] [FRAMES] [MAX_WORKERS]
+ *
+ * Every link has its own strand (per-link ordering) that decodes COBS
+ * frames and runs a (CPU-bound) handler for each. Link 'i' receives traffic
+ * in proportion to 1 / (i + 1). Reports aggregate frames/s for increasing
+ * worker counts.
+ */
+
+/* internal */
+#include "async/WorkStealingPool.h"
+#include "buffer/PcBuffer.h"
+#include "buffer/cobs/Decoder.h"
+#include "buffer/cobs/Encoder.h"
+
+/* toolchain */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Coral;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr std::size_t mtu = 256;
+static constexpr std::size_t payload = 128;
+static constexpr std::size_t frames_per_batch = 8;
+
+struct Link
+{
+    Link(WorkStealingPool &pool)
+        : strand(pool), buffer(), frames(0), checksum(0),
+          decoder([this](const std::array<uint8_t, mtu> &data,
+                         std::size_t size) { handle(data.data(), size); })
+    {
+    }
+
+    /* Stand-in for protocol handling. */
+    void handle(const uint8_t *data, std::size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (int round = 0; round < 16; round++)
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                hash = (hash ^ data[i]) * 16777619u;
+            }
+        }
+        checksum += hash;
+        frames++;
+    }
+
+    Strand strand;
+    PcBuffer<mtu * frames_per_batch * 2, uint8_t> buffer;
+    std::size_t frames;
+    uint32_t checksum;
+    Cobs::MessageDecoder<mtu> decoder;
+};
+
+static double run(std::size_t workers, std::size_t num_links,
+                  std::size_t frames, const std::vector<uint8_t> &batch)
+{
+    WorkStealingPool pool(workers);
+
+    std::vector<std::unique_ptr<Link>> links;
+    for (std::size_t i = 0; i < num_links; i++)
+    {
+        links.push_back(std::make_unique<Link>(pool));
+    }
+
+    /* Skewed (harmonic) traffic across links. */
+    double total_weight = 0.0;
+    for (std::size_t i = 0; i < num_links; i++)
+    {
+        total_weight += 1.0 / (i + 1);
+    }
+
+    auto start = Clock::now();
+
+    std::size_t posted = 0;
+    for (std::size_t i = 0; i < num_links; i++)
+    {
+        std::size_t batches = (frames / frames_per_batch) *
+                              (1.0 / (i + 1)) / total_weight;
+        batches = std::max<std::size_t>(batches, 1);
+
+        for (std::size_t j = 0; j < batches; j++)
+        {
+            Link *link = links[i].get();
+            link->strand.post([link, &batch]() {
+                link->buffer.push_n(batch.data(), batch.size());
+                link->decoder.dispatch(link->buffer);
+            });
+        }
+        posted += batches * frames_per_batch;
+    }
+
+    pool.wait_idle();
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::size_t handled = 0;
+    for (auto &link : links)
+    {
+        handled += link->frames;
+    }
+    if (handled != posted)
+    {
+        std::cerr << "Handled " << handled << " of " << posted << " frames."
+                  << std::endl;
+    }
+
+    uint32_t executed;
+    uint32_t stolen;
+    pool.poll_metrics(executed, stolen);
+
+    std::cout << "workers: " << workers << ", frames/s: "
+              << handled / elapsed.count() << ", jobs: " << executed
+              << ", stolen: " << stolen << std::endl;
+
+    return handled / elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t num_links = (argc > 1) ? std::atol(argv[1]) : 256;
+    std::size_t frames = (argc > 2) ? std::atol(argv[2]) : 200000;
+    std::size_t max_workers =
+        (argc > 3) ? std::atol(argv[3])
+                   : std::max(1u, std::thread::hardware_concurrency());
+
+    /* One batch of encoded frames (delivered to a link at a time). */
+    std::vector<uint8_t> frame(payload);
+    for (std::size_t i = 0; i < payload; i++)
+    {
+        frame[i] = i;
+    }
+
+    PcBuffer<mtu * frames_per_batch * 2, uint8_t> encoded;
+    for (std::size_t i = 0; i < frames_per_batch; i++)
+    {
+        Cobs::MessageEncoder encoder(frame.data(), frame.size());
+        encoder.encode(encoded);
+    }
+    std::vector<uint8_t> batch(encoded.state.data_available());
+    encoded.pop_n(batch.data(), batch.size());
+
+    double base = 0.0;
+    for (std::size_t workers = 1; workers <= max_workers; workers *= 2)
+    {
+        double rate = run(workers, num_links, frames, batch);
+        if (workers == 1)
+        {
+            base = rate;
+        }
+        else
+        {
+            std::cout << "  scaling: " << rate / base << "x" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+/* linux */
+#include <poll.h>
+#include <unistd.h>
+
+/* internal */
+#include "async/BufferAwaitables.h"
+#include "buffer/cobs/Encoder.h"
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 32;
+static constexpr std::size_t mtu = 64;
+using Buffer = PcBuffer<depth, uint8_t>;
+
+/* Write a frame (waiting for the buffer to drain as necessary). */
+Task send(Executor &executor, Buffer &buffer, const char *message)
+{
+    Cobs::MessageEncoder encoder(message, std::strlen(message));
+    while (not encoder.encode(buffer))
+    {
+        co_await drained(executor, buffer);
+    }
+}
+
+Task producer(Executor &executor, Buffer &buffer, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        /* Long enough that the buffer fills. */
+        co_await send(executor, buffer, "a reasonably long message");
+    }
+
+    co_await send(executor, buffer, "done");
+}
+
+Task consumer(Executor &executor, Buffer &buffer, int &received)
+{
+    AsyncDecoder<mtu> decoder(executor);
+
+    while (true)
+    {
+        auto frame = co_await decoder.next_frame(buffer);
+
+        if (frame.size() == 4 and std::memcmp(frame.data(), "done", 4) == 0)
+        {
+            break;
+        }
+
+        assert(frame.size() == std::strlen("a reasonably long message"));
+        received++;
+    }
+
+    uint32_t dropped;
+    decoder.poll_metrics(dropped);
+    assert(dropped == 0);
+}
+
+void test_frames(void)
+{
+    Executor executor;
+    Buffer buffer;
+    int received = 0;
+
+    executor.spawn(consumer(executor, buffer, received));
+    executor.spawn(producer(executor, buffer, 10));
+    assert(executor.pending() == 2);
+
+    executor.run();
+    assert(executor.pending() == 0);
+    assert(received == 10);
+    assert(buffer.empty());
+
+    uint32_t resumes;
+    uint32_t polls;
+    executor.poll_metrics(resumes, polls);
+    assert(resumes > 2 and polls > 1);
+}
+
+Task echo(Executor &executor, Buffer &input, Buffer &output, int count)
+{
+    std::array<uint8_t, 4> data;
+
+    for (int i = 0; i < count; i++)
+    {
+        assert(co_await pop_n(executor, input, data.data(), data.size()));
+        assert(co_await push_n(executor, output, data.data(), data.size()));
+    }
+
+    co_await drained(executor, output);
+
+    /* Let other tasks run. */
+    co_await yield(executor);
+    co_await space(executor, output, depth);
+    assert(output.empty());
+}
+
+void test_transfers(void)
+{
+    Executor executor;
+    Buffer input;
+    Buffer output;
+
+    executor.spawn(echo(executor, input, output, 3));
+
+    /* Pollers move data (e.g. service a link). */
+    uint8_t next = 0;
+    std::size_t echoed = 0;
+    executor.add_poller([&]() {
+        input.push(next++);
+        uint8_t elem;
+        while (ToBool(output.pop(elem)))
+        {
+            assert(elem == echoed++);
+        }
+    });
+
+    executor.run();
+    assert(echoed == 12);
+
+    /* Tasks that never finish are cleaned up with the executor. */
+    executor.spawn(echo(executor, input, output, 1000));
+    executor.poll();
+    assert(executor.pending() == 1);
+}
+
+Task receive(Executor &executor, Buffer &input, std::size_t count)
+{
+    std::array<uint8_t, 4> data;
+    assert(co_await pop_n(executor, input, data.data(), count));
+}
+
+void test_sleep(void)
+{
+    Executor executor;
+    Buffer input;
+    uint32_t resumes;
+    uint32_t polls;
+
+    /* Other threads wake the executor with 'notify'. */
+    std::atomic<bool> flag = false;
+    executor.spawn([](Executor &executor, std::atomic<bool> &flag) -> Task {
+        co_await until(executor, [&flag]() { return flag.load(); });
+    }(executor, flag));
+
+    std::thread notifier([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        flag = true;
+        executor.notify();
+    });
+
+    executor.run();
+    notifier.join();
+
+    /* A few polls (not a spin). */
+    executor.poll_metrics(resumes, polls);
+    assert(polls < 10);
+
+    /* Buffer callbacks notify the executor. */
+    notify_on(executor, input);
+    executor.spawn(receive(executor, input, 1));
+    executor.poll();
+    executor.poll();
+
+    /* Nothing changed, so the waiting coroutine isn't checked. */
+    assert(executor.poll() == 0);
+
+    /* New waiters are still checked (without checking the others). */
+    int checks = 0;
+    executor.wait(std::noop_coroutine(), [&checks]() {
+        checks++;
+        return true;
+    });
+    assert(executor.poll() == 1);
+    assert(checks == 1);
+    executor.poll();
+    assert(input.push(1));
+    assert(executor.poll() == 1);
+    assert(executor.pending() == 0);
+}
+
+void test_fd_poller(void)
+{
+    Executor executor;
+    Buffer input;
+
+    /* Data arrives through a descriptor (the executor sleeps until then). */
+    int fds[2];
+    assert(pipe(fds) == 0);
+    executor.add_poller(fds[0], POLLIN, [&]() {
+        auto region = input.write_region();
+        ssize_t count = read(fds[0], region.data(), region.size());
+        if (count > 0)
+        {
+            input.commit_write(count);
+        }
+    });
+    executor.spawn(receive(executor, input, 4));
+
+    std::thread writer([&fds]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(write(fds[1], "ab", 2) == 2);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(write(fds[1], "cd", 2) == 2);
+    });
+
+    executor.run();
+    writer.join();
+
+    /* A few polls per write (not a spin). */
+    uint32_t resumes;
+    uint32_t polls;
+    executor.poll_metrics(resumes, polls);
+    assert(polls < 10);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main(void)
+{
+    test_frames();
+    test_transfers();
+    test_sleep();
+    test_fd_poller();
+    return 0;
+}
@@ -0,0 +1,248 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+/* linux */
+#include <sched.h>
+
+/* internal */
+#include "async/Pipeline.h"
+#include "buffer/PcBuffer.h"
+
+using namespace Coral;
+
+static constexpr std::size_t mtu = 32;
+using Buffer = PcBuffer<256, uint8_t>;
+using Ring = SpscRing<Frame<mtu>, 4>;
+
+void test_spsc_ring(void)
+{
+    SpscRing<int, 4> ring;
+    int value;
+
+    assert(not ring.try_pop(value));
+    assert(ring.peek() == nullptr);
+
+    for (int i = 0; i < 4; i++)
+    {
+        assert(ring.try_push(i));
+    }
+    assert(ring.full());
+    assert(not ring.try_push(4));
+    assert(ring.claim() == nullptr);
+
+    uint32_t full_count;
+    ring.poll_metrics(full_count);
+    assert(full_count == 2);
+
+    assert(ring.try_pop(value) and value == 0);
+    assert(*ring.peek() == 1);
+    ring.pop();
+
+    /* Fill an element in place. */
+    int *slot = ring.claim();
+    assert(slot);
+    *slot = 4;
+    ring.publish();
+
+    for (int i = 2; i < 5; i++)
+    {
+        assert(ring.try_pop(value) and value == i);
+    }
+    assert(not ring.try_pop(value));
+
+    /* Elements arrive in order across threads. */
+    static constexpr int count = 100000;
+    SpscRing<int, 8> shared;
+
+    std::thread producer([&shared]() {
+        for (int i = 0; i < count; i++)
+        {
+            while (not shared.try_push(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 0; i < count; i++)
+    {
+        while (not shared.try_pop(value))
+        {
+            std::this_thread::yield();
+        }
+        assert(value == i);
+    }
+
+    producer.join();
+}
+
+/* Get the frame (before encoding) for a given index. */
+std::vector<uint8_t> make_frame(int index)
+{
+    char data[mtu];
+    int length = std::snprintf(data, sizeof(data), "frame %d", index);
+    return std::vector<uint8_t>(data, data + length);
+}
+
+/* Encode frames into the input buffer a chunk at a time. */
+class Source
+{
+  public:
+    Source(Buffer &_buffer, int frames) : buffer(_buffer), data(), position(0)
+    {
+        Buffer scratch;
+
+        for (int i = 0; i < frames; i++)
+        {
+            auto frame = make_frame(i);
+            Cobs::MessageEncoder encoder(frame.data(), frame.size());
+            assert(encoder.encode(scratch));
+
+            uint8_t elem;
+            while (ToBool(scratch.pop(elem)))
+            {
+                data.push_back(elem);
+            }
+        }
+    }
+
+    void operator()(void)
+    {
+        position += buffer.try_push_n(data.data() + position,
+                                      data.size() - position);
+    }
+
+  protected:
+    Buffer &buffer;
+    std::vector<uint8_t> data;
+    std::size_t position;
+};
+
+bool first_cpu_allowed(void)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    return sched_getaffinity(0, sizeof(set), &set) == 0 and
+           CPU_ISSET(0, &set);
+}
+
+void test_pipeline(void)
+{
+    static constexpr int frames = 2000;
+
+    Buffer rx;
+    PcBuffer<64, uint8_t> tx;
+    Ring decoded;
+    Ring handled;
+
+    Source source(rx, frames);
+    DecodeStage decode(rx, decoded, [&source]() { source(); });
+
+    /* Increment every byte. */
+    HandlerStage<Frame<mtu>, Frame<mtu>, 4, 4> handle(
+        decoded, handled, [](const Frame<mtu> &in, Frame<mtu> &out) {
+            for (std::size_t i = 0; i < in.size; i++)
+            {
+                out.data[i] = in.data[i] + 1;
+            }
+            out.size = in.size;
+            return true;
+        });
+
+    /* Check the output (on the encoding thread). */
+    std::atomic<int> received = 0;
+    std::atomic<int> mismatched = 0;
+    Cobs::MessageDecoder<mtu> check(
+        [&](const std::array<uint8_t, mtu> &message, std::size_t size) {
+            auto expected = make_frame(received++);
+            bool match = size == expected.size();
+            for (std::size_t i = 0; match and i < size; i++)
+            {
+                match = message[i] == expected[i] + 1;
+            }
+            if (not match)
+            {
+                mismatched++;
+            }
+        });
+
+    EncodeStage encode(handled, tx, [&]() { check.dispatch(tx); });
+
+    Pipeline pipeline;
+    bool pin = first_cpu_allowed();
+    pipeline.add(decode, (pin) ? 0 : StageThread::any_cpu);
+    pipeline.add(handle);
+    pipeline.add(encode);
+    assert(pipeline.size() == 3);
+    assert(pipeline[0].pinned() == pin);
+    assert(not pipeline[1].pinned());
+
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (received < frames and std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pipeline.stop();
+
+    /* Small rings mean stages stalled, but nothing was lost. */
+    assert(received == frames);
+    assert(mismatched == 0);
+
+    uint32_t dropped;
+    decode.poll_metrics(dropped);
+    assert(dropped == 0);
+
+    uint32_t steps;
+    uint32_t idle;
+    pipeline[2].poll_metrics(steps, idle);
+    assert(steps >= idle);
+}
+
+void test_stop_while_full(void)
+{
+    Buffer rx;
+    Ring decoded;
+
+    /* Nothing consumes the ring, so decoding stalls after four frames. */
+    Source source(rx, 10);
+    source();
+    DecodeStage decode(rx, decoded);
+
+    {
+        Pipeline pipeline;
+        pipeline.add(decode);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    /* Stopping abandons the blocked frame (and the rest of the input). */
+    uint32_t dropped;
+    decode.poll_metrics(dropped);
+    assert(dropped == 6);
+
+    Frame<mtu> frame;
+    for (int i = 0; i < 4; i++)
+    {
+        assert(decoded.try_pop(frame));
+        auto expected = make_frame(i);
+        assert(std::ranges::equal(frame.view(), expected));
+    }
+}
+
+int main(void)
+{
+    test_spsc_ring();
+    test_pipeline();
+    test_stop_while_full();
+    return 0;
+}
@@ -0,0 +1,124 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <vector>
+
+/* internal */
+#include "async/WorkStealingPool.h"
+
+using namespace Coral;
+
+void test_jobs(void)
+{
+    WorkStealingPool pool(4);
+    assert(pool.size() == 4);
+
+    std::atomic<int> count = 0;
+
+    /* Jobs can submit more jobs (to their worker's own queue). */
+    for (int i = 0; i < 100; i++)
+    {
+        pool.submit([&pool, &count]() {
+            count++;
+            for (int j = 0; j < 10; j++)
+            {
+                pool.submit([&count]() { count++; });
+            }
+        });
+    }
+
+    pool.wait_idle();
+    assert(count == 100 * 11);
+
+    uint32_t executed;
+    uint32_t stolen;
+    pool.poll_metrics(executed, stolen);
+    assert(executed == 100 * 11);
+}
+
+void test_strands(void)
+{
+    static constexpr std::size_t num_strands = 8;
+    static constexpr int jobs = 1000;
+
+    WorkStealingPool pool(4);
+
+    std::vector<std::unique_ptr<Strand>> strands;
+    std::array<std::vector<int>, num_strands> results;
+    std::array<std::atomic<int>, num_strands> running = {};
+
+    for (std::size_t i = 0; i < num_strands; i++)
+    {
+        strands.push_back(std::make_unique<Strand>(pool, 4));
+    }
+
+    /* Each strand runs its jobs one at a time, in order. */
+    for (int job = 0; job < jobs; job++)
+    {
+        for (std::size_t i = 0; i < num_strands; i++)
+        {
+            strands[i]->post([&results, &running, i, job]() {
+                assert(running[i]++ == 0);
+                results[i].push_back(job);
+                running[i]--;
+            });
+        }
+    }
+
+    pool.wait_idle();
+
+    for (auto &result : results)
+    {
+        assert(result.size() == jobs);
+        for (int job = 0; job < jobs; job++)
+        {
+            assert(result[job] == job);
+        }
+    }
+}
+
+void test_strand_fairness(void)
+{
+    static constexpr int limit = 100000;
+
+    /* A single worker, so strands can only take turns. */
+    WorkStealingPool pool(1);
+    Strand busy(pool, 4);
+    Strand other(pool, 4);
+
+    std::atomic<bool> ran = false;
+    int spins = 0;
+
+    /* A strand that always has more work (until the other one runs). */
+    std::function<void()> job = [&]() {
+        if (spins++ == 0)
+        {
+            other.post([&ran]() { ran = true; });
+        }
+        if (not ran and spins < limit)
+        {
+            busy.post(job);
+        }
+    };
+    busy.post(job);
+
+    pool.wait_idle();
+
+    /* The other strand ran after (about) one batch. */
+    assert(ran);
+    assert(spins <= 8);
+}
+
+int main(void)
+{
+    test_jobs();
+    test_strands();
+    test_strand_fairness();
+    return 0;
+}
@@ -0,0 +1,114 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <cassert>
+#include <cstring>
+
+/* internal */
+#include "buffer/BroadcastBuffer.h"
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 16;
+using Buffer = BroadcastBuffer<depth, char, 2>;
+
+void test_follow(void)
+{
+    Buffer buf;
+
+    /* Without readers, writes always succeed. */
+    assert(buf.push_n("abcd", 4));
+
+    Buffer::Reader fast(buf);
+    Buffer::Reader slow(buf);
+    assert(buf.num_readers() == 2);
+    assert(fast.empty());
+
+    /* Both readers see every element. */
+    assert(buf.push_n("hello", 5));
+    char data[depth];
+    assert(fast.pop_n(data, 5));
+    assert(std::memcmp(data, "hello", 5) == 0);
+    assert(slow.read_region().size() == 5);
+    assert(slow.peek() == 'h');
+
+    /* The slowest reader limits the writer. */
+    assert(buf.space() == depth - 5);
+    assert(buf.try_push_n("0123456789abcdefg", 17) == depth - 5);
+    assert(buf.full());
+    assert(not buf.push('x', true));
+
+    uint16_t write_dropped;
+    buf.poll_metrics(write_dropped);
+    assert(write_dropped == 1);
+
+    assert(slow.pop_all() == depth);
+    assert(buf.space() == depth - fast.data_available());
+
+    /* Blocking writes service readers. */
+    buf.set_data_available([&fast, &slow](Buffer *) {
+        fast.pop_all();
+        slow.pop_all();
+    });
+    std::array<char, depth * 3> array = {};
+    buf.push_n_blocking(array);
+    assert(fast.empty() and slow.empty());
+}
+
+void test_lap(void)
+{
+    Buffer buf(true);
+    Buffer::Reader reader(buf);
+
+    {
+        /* Readers detach when destroyed. */
+        Buffer::Reader other(buf);
+        assert(buf.num_readers() == 2);
+    }
+    assert(buf.num_readers() == 1);
+    assert(reader.valid());
+
+    {
+        /* Readers beyond the last slot are invalid and never read. */
+        Buffer::Reader other(buf);
+        Buffer::Reader extra(buf);
+        assert(other.valid());
+        assert(not extra.valid());
+        assert(buf.num_readers() == 2);
+
+        assert(buf.push('x'));
+        assert(other.data_available() == 1);
+        assert(extra.empty());
+
+        char elem;
+        assert(not extra.pop(elem));
+        assert(extra.read_region().empty());
+        assert(reader.pop(elem));
+    }
+    assert(buf.num_readers() == 1);
+
+    for (std::size_t i = 0; i < depth + 4; i++)
+    {
+        assert(buf.push(static_cast<char>(i)));
+    }
+
+    /* The reader skips what was overwritten (peeking or popping). */
+    assert(reader.peek() == 4);
+    assert(reader.data_available() == depth);
+    char elem;
+    assert(reader.pop(elem));
+    assert(elem == 4);
+
+    uint32_t lapped;
+    reader.poll_metrics(lapped);
+    assert(lapped == 4);
+}
+
+int main(void)
+{
+    test_follow();
+    test_lap();
+    return 0;
+}
@@ -2,9 +2,108 @@
 #undef NDEBUG
 #endif
 
+/* toolchain */
+#include <cassert>
+#include <thread>
+
 /* internal */
 #include "SampleFdBuffer.h"
 
+/* Counts transmit-end writes (draining the buffer each time). */
+class CountingBuffer
+    : public FullDuplexBuffer<CountingBuffer, depth, depth, element_t>
+{
+  public:
+    inline void service_tx_impl(TxBuffer *buf)
+    {
+        if (not buf->empty())
+        {
+            written += (limit) ? buf->try_pop_n(nullptr, limit)
+                               : buf->pop_all();
+            writes++;
+        }
+    }
+
+    inline void service_rx_impl(RxBuffer *buf)
+    {
+        (void)buf;
+    }
+
+    std::size_t writes = 0;
+    std::size_t written = 0;
+
+    /* The most elements written at a time (zero for no limit). */
+    std::size_t limit = 0;
+};
+
+void test_coalescing(void)
+{
+    CountingBuffer buffer;
+
+    /* Without coalescing, every push is written. */
+    for (int i = 0; i < 10; i++)
+    {
+        assert(buffer.tx.push('a'));
+    }
+    assert(buffer.writes == 10);
+
+    /* Data is held until the threshold is reached. */
+    buffer.set_coalescing(8, 1000000);
+    buffer.writes = 0;
+    for (int i = 0; i < 15; i++)
+    {
+        assert(buffer.tx.push('a'));
+    }
+    assert(buffer.writes == 1);
+    assert(buffer.written == 18);
+
+    /* Held data is written explicitly. */
+    buffer.flush_tx();
+    assert(buffer.writes == 2);
+    assert(buffer.tx.empty());
+
+    /* Flushing the buffer itself doesn't wait for the held data. */
+    assert(buffer.tx.push('a'));
+    assert(buffer.writes == 2);
+    buffer.tx.flush();
+    assert(buffer.writes == 3);
+    assert(buffer.tx.empty());
+    assert(not buffer.tx.flushing());
+    buffer.writes = 2;
+
+    /* Held data is written once its deadline expires. */
+    buffer.set_coalescing(8, 1000);
+    assert(buffer.tx.push('a'));
+    buffer.dispatch();
+    assert(buffer.writes == 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    buffer.dispatch();
+    assert(buffer.writes == 3);
+
+    uint32_t deferred;
+    uint32_t deadline_flushes;
+    buffer.poll_coalescing_metrics(deferred, deadline_flushes);
+    assert(deferred == 4);
+    assert(deadline_flushes == 1);
+
+    /* Data left by a partial write doesn't wait for a new deadline. */
+    buffer.set_coalescing(8, 10000);
+    buffer.limit = 4;
+    buffer.writes = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        assert(buffer.tx.push('a'));
+    }
+    assert(buffer.writes == 1);
+    assert(buffer.tx.state.data_available() == 4);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    buffer.dispatch();
+    assert(buffer.writes == 2);
+    assert(buffer.tx.empty());
+}
+
 int main(void)
 {
     SampleFdBuffer buffer;
@@ -16,5 +115,7 @@ int main(void)
     std::stringstream("Hello, world! (rx)\n") >> buffer.rx;
     std::cout << buffer.rx;
 
+    test_coalescing();
+
     return 0;
 }
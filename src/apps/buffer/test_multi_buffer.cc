@@ -0,0 +1,249 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+/* linux */
+#include <unistd.h>
+
+/* internal */
+#include "buffer/MultiBuffer.h"
+#include "buffer/PcBuffer.h"
+#include "buffer/cobs/Decoder.h"
+#include "buffer/cobs/Encoder.h"
+
+using namespace Coral;
+
+void test_blocks(void)
+{
+    int data_count = 0;
+    int space_count = 0;
+
+    MultiBuffer<8, 2, uint8_t> buffer(
+        [&space_count](auto *buf) {
+            (void)buf;
+            space_count++;
+        },
+        [&data_count](auto *buf) {
+            (void)buf;
+            data_count++;
+        });
+
+    assert(buffer.free_blocks() == 2);
+    assert(buffer.ready_blocks() == 0);
+    assert(buffer.acquire_drain().empty());
+
+    /* Fill part of one block and all of the other. */
+    auto block = buffer.acquire_fill();
+    assert(block.size() == 8);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        block[i] = i;
+    }
+
+    /* Publishing nothing keeps the same block. */
+    buffer.publish(0);
+    assert(buffer.acquire_fill().data() == block.data());
+    buffer.publish(3);
+    assert(data_count == 1);
+
+    block = buffer.acquire_fill();
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        block[i] = 3 + i;
+    }
+    buffer.publish();
+
+    assert(buffer.free_blocks() == 0);
+    assert(buffer.ready_blocks() == 2);
+    assert(buffer.available() == 11);
+
+    /* The producer is out of blocks (retrying isn't an overrun). */
+    assert(buffer.acquire_fill().empty());
+    assert(buffer.acquire_fill().empty());
+    buffer.drop();
+
+    uint32_t overruns;
+    uint32_t published;
+    buffer.poll_metrics(overruns, published);
+    assert(overruns == 1);
+    assert(published == 2);
+
+    /* Drain the first block in place. */
+    auto region = buffer.acquire_drain();
+    assert(region.size() == 3 and region[2] == 2);
+    buffer.release();
+    assert(space_count == 1);
+    assert(buffer.free_blocks() == 1);
+
+    /* Read across blocks (all or nothing). */
+    std::array<uint8_t, 4> elems;
+    assert(ToBool(buffer.pop(elems)));
+    assert(elems[0] == 3 and elems[3] == 6);
+    assert(buffer.available() == 4);
+    assert(buffer.acquire_drain().size() == 4);
+
+    std::array<uint8_t, 5> too_many;
+    assert(not ToBool(buffer.pop(too_many)));
+    assert(buffer.try_pop_n(too_many) == 4);
+    assert(too_many[3] == 10);
+
+    assert(buffer.available() == 0);
+    assert(buffer.free_blocks() == 2);
+    assert(space_count == 2);
+
+    /* Blocks are reused in order. */
+    for (uint8_t round = 0; round < 5; round++)
+    {
+        block = buffer.acquire_fill();
+        block[0] = round;
+        buffer.publish(1);
+
+        uint8_t elem;
+        assert(ToBool(buffer.pop(elem)) and elem == round);
+    }
+    assert(buffer.pop_all() == 0);
+}
+
+void test_decoder(void)
+{
+    static constexpr std::size_t mtu = 64;
+
+    /* Encode a few frames. */
+    PcBuffer<256, uint8_t> encoded;
+    for (int i = 0; i < 4; i++)
+    {
+        char message[mtu];
+        int length = std::snprintf(message, sizeof(message), "message %d", i);
+        Cobs::MessageEncoder encoder(message, length);
+        assert(encoder.encode(encoded));
+    }
+
+    /* Frames span blocks (which are handed off whole). */
+    MultiBuffer<16, 4, uint8_t> buffer;
+
+    int received = 0;
+    Cobs::MessageDecoder<mtu> decoder(
+        [&received](const std::array<uint8_t, mtu> &data, std::size_t size) {
+            char expected[mtu];
+            int length = std::snprintf(expected, sizeof(expected),
+                                       "message %d", received++);
+            assert(size == (std::size_t)length);
+            assert(std::memcmp(data.data(), expected, size) == 0);
+        });
+
+    while (encoded.state.data_available())
+    {
+        auto block = buffer.acquire_fill();
+        if (block.empty())
+        {
+            decoder.dispatch(buffer);
+            continue;
+        }
+
+        std::size_t count = encoded.try_pop_n(block.data(), block.size());
+        buffer.publish(count);
+    }
+    decoder.dispatch(buffer);
+
+    assert(received == 4);
+    assert(buffer.ready_blocks() == 0);
+}
+
+void test_read(void)
+{
+    /* Fixed-size reads land directly in blocks. */
+    int fds[2];
+    assert(pipe(fds) == 0);
+
+    const char message[] = "abcdefghijklmnopqrstuvwxyz";
+    assert(write(fds[1], message, 26) == 26);
+    close(fds[1]);
+
+    MultiBuffer<10, 2, char> buffer;
+    std::string result;
+
+    while (true)
+    {
+        auto block = buffer.acquire_fill();
+        assert(not block.empty());
+
+        ssize_t count = read(fds[0], block.data(), block.size());
+        if (count <= 0)
+        {
+            break;
+        }
+        buffer.publish(count);
+
+        auto region = buffer.acquire_drain();
+        result.append(region.data(), region.size());
+        buffer.release();
+    }
+    close(fds[0]);
+
+    assert(result == message);
+}
+
+void test_threads(void)
+{
+    static constexpr std::size_t blocks = 10000;
+    MultiBuffer<32, 2, uint32_t> buffer;
+
+    std::thread producer([&buffer]() {
+        uint32_t value = 0;
+
+        for (std::size_t i = 0; i < blocks; i++)
+        {
+            std::span<uint32_t> block;
+            while ((block = buffer.acquire_fill()).empty())
+            {
+                std::this_thread::yield();
+            }
+
+            /* Blocks are published partially filled. */
+            std::size_t count = 1 + i % block.size();
+            for (std::size_t j = 0; j < count; j++)
+            {
+                block[j] = value++;
+            }
+            buffer.publish(count);
+        }
+    });
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < blocks; i++)
+    {
+        total += 1 + i % 32;
+    }
+
+    uint32_t expected = 0;
+    while (expected < total)
+    {
+        uint32_t elem;
+        if (ToBool(buffer.pop(elem)))
+        {
+            assert(elem == expected++);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+}
+
+int main(void)
+{
+    test_blocks();
+    test_decoder();
+    test_read();
+    test_threads();
+    return 0;
+}
@@ -90,6 +90,81 @@ void test_drop_data(Buffer &buf)
     buf.pop_all();
 }
 
+void test_write_region(Buffer &buf)
+{
+    buf.pop_all();
+
+    /* Regions don't wrap around the end of the buffer. */
+    auto region = buf.write_region();
+    assert(not region.empty());
+    assert(region.size() <= depth);
+
+    region[0] = 'a';
+    region[1] = 'b';
+    assert(buf.commit_write(2));
+    assert(buf.read_region().size() == 2);
+    assert(buf.peek() == 'a');
+
+    buf.pop_all();
+    assert(buf.empty());
+}
+
+void test_overwrite(void)
+{
+    Buffer buf;
+    buf.set_overwrite();
+
+    /* Writes always succeed, the oldest elements are discarded. */
+    for (std::size_t i = 0; i < depth + 3; i++)
+    {
+        assert(buf.push(static_cast<element_t>(i)));
+    }
+    assert(buf.full());
+    assert(buf.state.write_dropped == 0);
+    assert(buf.lapped() == 3);
+    assert(buf.lapped() == 0);
+
+    element_t val;
+    assert(buf.pop(val));
+    assert(val == static_cast<element_t>(3));
+
+    /* Only the newest elements of a large write are kept. */
+    std::array<element_t, depth * 2 + 1> data;
+    for (std::size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<element_t>(i);
+    }
+    assert(buf.push_n(data.data(), data.size()));
+    assert(buf.full());
+    assert(buf.lapped() == depth - 1 + depth + 1);
+    assert(buf.peek() == data[depth + 1]);
+
+    /* Oversized writes only signal the data that's kept. */
+    int signalled = 0;
+    buf.set_data_available([&signalled](auto *) { signalled++; });
+    assert(buf.push_n(data.data(), data.size()));
+    assert(signalled == 1);
+    assert(buf.lapped() == depth + depth + 1);
+    assert(buf.peek() == data[depth + 1]);
+    buf.set_data_available();
+
+    /* Blocking writes don't wait for space. */
+    buf.push_blocking(val);
+    buf.push_n_blocking(data);
+    assert(buf.try_push_n(data.data(), 2) == 2);
+
+    uint16_t high_watermark;
+    uint16_t write_dropped;
+    uint32_t overwritten;
+    buf.state.poll_metrics(high_watermark, write_dropped, overwritten);
+    assert(overwritten == 3 + (depth - 1 + depth + 1) + data.size() + 1 +
+                              data.size() + 2);
+    assert(write_dropped == 0);
+
+    buf.set_overwrite(false);
+    assert(not buf.push(val));
+}
+
 void test_stream_interfaces(Buffer &buf)
 {
     /* Ensure the buffer is empty. */
@@ -117,6 +192,8 @@ int main(void)
 
     Buffer buf2 = {};
     test_drop_data(buf2);
+    test_write_region(buf2);
+    test_overwrite();
 
     test_stream_interfaces(buf2);
 
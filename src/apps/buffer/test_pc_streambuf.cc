@@ -0,0 +1,69 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/* internal */
+#include "buffer/PcStreambuf.h"
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 16;
+using Buffer = PcBuffer<depth, char>;
+
+int main(void)
+{
+    Buffer buffer;
+
+    {
+        PcStreambuf<depth> streambuf(buffer);
+        std::ostream output(&streambuf);
+        std::istream input(&streambuf);
+
+        /* Writes are added to the buffer when flushed. */
+        output << "hello " << 42;
+        assert(buffer.empty());
+        output.flush();
+        assert(buffer.state.data_available() == 8);
+
+        std::string word;
+        int value;
+        input >> word >> value;
+        assert(word == "hello");
+        assert(value == 42);
+        assert(buffer.empty());
+
+        /* Writes wrap around the end of the buffer. */
+        output << "0123456789abcdef" << std::flush;
+        assert(buffer.full());
+        assert(output.good());
+
+        /* Writing to a full buffer fails. */
+        output << 'x' << std::flush;
+        assert(output.bad());
+
+        /* Reading reached the end of the buffer earlier. */
+        input.clear();
+        std::string all;
+        input >> all;
+        assert(all == "0123456789abcdef");
+        assert(buffer.empty());
+    }
+
+    /* Stream operators read and write the buffer in place. */
+    std::stringstream("more than sixteen elements") >> buffer;
+    assert(buffer.full());
+
+    std::stringstream result;
+    result << buffer;
+    assert(result.str() == "more than sixtee");
+    assert(buffer.empty());
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <cassert>
+#include <chrono>
+
+/* internal */
+#include "buffer/PcBuffer.h"
+#include "buffer/RateLimitedWriter.h"
+
+using namespace Coral;
+
+using Buffer = PcBuffer<1024, char>;
+
+/* A clock that only moves when told to. */
+struct TestClock
+{
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<TestClock>;
+    static constexpr bool is_steady = true;
+
+    static inline duration current = duration(0);
+
+    static time_point now()
+    {
+        return time_point(current);
+    }
+
+    static void advance(std::chrono::nanoseconds amount)
+    {
+        current += amount;
+    }
+};
+
+void test_tokens(void)
+{
+    using namespace std::chrono_literals;
+
+    Buffer buf;
+    RateLimitedWriter<Buffer, char, TestClock> writer(buf, 1000, 10);
+
+    /* The bucket starts full. */
+    assert(writer.available() == 10);
+    assert(writer.push_n("0123456789", 10));
+    assert(not writer.push('x'));
+    assert(writer.try_push_n("abc", 3) == 0);
+
+    /* Tokens accumulate at the configured rate. */
+    TestClock::advance(1ms);
+    assert(writer.available() == 1);
+    assert(writer.push('x'));
+
+    /* Partial tokens aren't lost. */
+    TestClock::advance(1500us);
+    assert(writer.available() == 1);
+    TestClock::advance(500us);
+    assert(writer.available() == 2);
+
+    /* Partial progress is made with the tokens available. */
+    assert(writer.try_push_n("abc", 3) == 2);
+
+    /* Tokens never exceed the burst size. */
+    TestClock::advance(1s);
+    assert(writer.available() == 10);
+
+    /* Writes larger than the burst size can never succeed. */
+    assert(not writer.push_n("0123456789a", 11));
+    assert(writer.available() == 10);
+
+    /* Only writes that lacked tokens were throttled. */
+    uint32_t throttled;
+    uint32_t throttle_time;
+    writer.poll_metrics(throttled, throttle_time);
+    assert(throttled == 3);
+    assert(throttle_time == 0);
+
+    assert(buf.state.data_available() == 13);
+
+    /*
+     * Long idle periods at high rates don't overflow (2^38 ns at 2^26
+     * elements per second is exactly 2^64 element-nanoseconds).
+     */
+    writer.configure(1u << 26, 10);
+    assert(writer.push_n("0123456789", 10));
+    TestClock::advance(std::chrono::nanoseconds(1ull << 38));
+    assert(writer.available() == 10);
+}
+
+void test_blocking(void)
+{
+    Buffer buf;
+    buf.set_data_available([](Buffer *buf) { buf->pop_all(); });
+
+    /* 100 kB/s, writing 2 kB takes (at least) 10 ms beyond the burst. */
+    RateLimitedWriter<Buffer, char> writer(buf, 100000, 1000);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::array<char, 2000> data = {};
+    writer.push_n_blocking(data);
+    writer.push_blocking('x');
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    assert(elapsed >= std::chrono::milliseconds(10));
+
+    uint32_t throttled;
+    uint32_t throttle_time;
+    writer.poll_metrics(throttled, throttle_time);
+    assert(throttled >= 1);
+    assert(throttle_time >= 10000);
+}
+
+int main(void)
+{
+    test_tokens();
+    test_blocking();
+    return 0;
+}
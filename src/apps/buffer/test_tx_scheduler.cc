@@ -0,0 +1,230 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* toolchain */
+#include <cassert>
+#include <cstring>
+
+/* internal */
+#include "buffer/TxScheduler.h"
+#include "buffer/cobs/Decoder.h"
+#include "buffer/cobs/Encoder.h"
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 256;
+using Scheduler = TxScheduler<depth, 3>;
+using Output = PcBuffer<64, uint8_t>;
+
+/* Queue a frame of 'size' elements (including the delimiter). */
+template <class Queue>
+void frame(Queue &queue, uint8_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size - 1; i++)
+    {
+        assert(queue.push(value));
+    }
+    assert(queue.push(0));
+}
+
+void test_priority(void)
+{
+    Scheduler scheduler;
+    scheduler.configure(0, 0);
+    scheduler.configure(1, 1);
+    scheduler.configure(2, 1);
+
+    Output output;
+
+    /* Bulk data is queued first. */
+    for (int i = 0; i < 8; i++)
+    {
+        frame(scheduler[1], 'b', 16);
+    }
+    frame(scheduler[0], 'c', 4);
+
+    /* Control frames are sent first. */
+    assert(scheduler.service(output) == output.state.size);
+    uint8_t data[4];
+    assert(output.pop_n(data, 4));
+    assert(std::memcmp(data, "ccc\0", 4) == 0);
+
+    /* Incomplete frames aren't sent. */
+    assert(scheduler[0].push('c'));
+    output.pop_all();
+    scheduler.service(output);
+    assert(output.full());
+    assert(scheduler[0].state.data_available() == 1);
+
+    /* The bulk frame that didn't fit was finished first. */
+    assert(output.pop_n(data, 4));
+    assert(std::memcmp(data, "bbb\0", 4) == 0);
+
+    /* Completed control frames go next (after the current frame). */
+    assert(scheduler[0].push(0));
+    output.pop_all();
+    scheduler.service(output);
+    assert(output.pop_n(data, 4));
+    assert(std::memcmp(data, "bbb\0", 4) == 0);
+    assert(output.pop_n(data, 2));
+    assert(std::memcmp(data, "c\0", 2) == 0);
+
+    uint32_t frames;
+    uint32_t elements;
+    scheduler.poll_metrics(0, frames, elements);
+    assert(frames == 2);
+    assert(elements == 6);
+}
+
+void test_fairness(void)
+{
+    Scheduler scheduler;
+    scheduler.configure(0, 0, 32);
+    scheduler.configure(1, 0, 16);
+    scheduler.configure(2, 2);
+
+    Output output;
+    scheduler.attach(output);
+
+    /* Two same-priority queues share the output 2:1 (by quantum). */
+    std::size_t counts[2] = {};
+    for (int round = 0; round < 64; round++)
+    {
+        while (scheduler[0].state.space_available() >= 16)
+        {
+            frame(scheduler[0], 'a', 16);
+        }
+        while (scheduler[1].state.space_available() >= 16)
+        {
+            frame(scheduler[1], 'b', 16);
+        }
+
+        /* Consuming output refills it (both queues stay backlogged). */
+        uint8_t elem;
+        for (int i = 0; i < 96 and ToBool(output.pop(elem)); i++)
+        {
+            if (elem == 'a')
+            {
+                counts[0]++;
+            }
+            else if (elem == 'b')
+            {
+                counts[1]++;
+            }
+        }
+    }
+
+    double ratio = double(counts[0]) / double(counts[1]);
+    assert(ratio > 1.8 and ratio < 2.2);
+}
+
+void test_cobs(void)
+{
+    Scheduler scheduler;
+    Output output;
+    scheduler.attach(output);
+
+    std::size_t received = 0;
+    Cobs::MessageDecoder<depth> decoder(
+        [&received](const std::array<uint8_t, depth> &message,
+                    std::size_t size) {
+            assert(size == 3 or size == 40);
+            if (size == 3)
+            {
+                assert(std::memcmp(message.data(), "a\0b", 3) == 0);
+            }
+            received++;
+        });
+
+    /* Frames from different queues never interleave. */
+    std::array<uint8_t, 40> large = {};
+    for (int i = 0; i < 10; i++)
+    {
+        Cobs::MessageEncoder small("a\0b", 3);
+        assert(small.encode(scheduler[i % 3]));
+
+        Cobs::MessageEncoder encoder(large.data(), large.size());
+        while (not encoder.encode(scheduler[(i + 1) % 3]))
+        {
+            decoder.dispatch(output);
+        }
+    }
+    while (not output.empty())
+    {
+        decoder.dispatch(output);
+    }
+
+    assert(received == 20);
+}
+
+/* Exposes scheduling state. */
+struct InspectScheduler : public TxScheduler<64, 2>
+{
+    using TxScheduler<64, 2>::classes;
+};
+
+void test_partial_deficit(void)
+{
+    InspectScheduler scheduler;
+    scheduler.configure(0, 0, 10);
+    scheduler.configure(1, 0, 10);
+
+    PcBuffer<64, uint8_t> output;
+
+    /* A frame followed by the start of another. */
+    frame(scheduler[0], 'a', 4);
+    assert(scheduler[0].push('a'));
+    frame(scheduler[1], 'b', 4);
+
+    scheduler.service(output);
+    assert(output.state.data_available() == 8);
+
+    /* The queue with a partial frame kept its unused credit. */
+    assert(scheduler.classes[0].deficit == 6);
+    assert(scheduler.classes[1].deficit == 0);
+}
+
+void test_oversized(void)
+{
+    TxScheduler<16, 2> scheduler;
+    scheduler.configure(0, 0);
+    scheduler.configure(1, 0);
+
+    /* Nothing is attached, so service the output by hand. */
+    PcBuffer<64, uint8_t> output;
+
+    /* A frame longer than the queue is dropped (as it arrives). */
+    for (int i = 0; i < 40; i++)
+    {
+        assert(scheduler[0].push('x'));
+        scheduler.service(output);
+    }
+    assert(scheduler[0].push(0));
+    assert(scheduler[0].push('y'));
+    assert(scheduler[0].push(0));
+    scheduler.service(output);
+
+    /* The next frame is still sent. */
+    uint8_t data[2];
+    assert(output.state.data_available() == 2);
+    assert(output.pop_n(data, 2));
+    assert(data[0] == 'y' and data[1] == 0);
+
+    uint32_t frames;
+    uint32_t elements;
+    uint32_t oversized;
+    scheduler.poll_metrics(0, frames, elements, oversized);
+    assert(frames == 1);
+    assert(oversized == 1);
+}
+
+int main(void)
+{
+    test_priority();
+    test_fairness();
+    test_cobs();
+    test_oversized();
+    test_partial_deficit();
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Compare the tokenizer (with its default single delimiter, and with quoting
+ * enabled) against a per-element loop (the previous StringCommandProcessor
+ * implementation) on a short command line and on long argument lines.
+ *
+ * usage: bench_tokenizer [ITERATIONS]
+ */
+
+/* internal */
+#include "cli/Tokenizer.h"
+
+/* toolchain */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace Coral;
+
+static constexpr std::size_t max_args = 64;
+
+static std::size_t legacy_tokenize(char *line, std::size_t length,
+                                   const char **args)
+{
+    std::size_t num_args = 0;
+    std::size_t token_start = 0;
+    std::size_t token_len = 0;
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        if (line[i] == ' ')
+        {
+            line[i] = '\0';
+
+            if (token_len)
+            {
+                args[num_args++] = &line[token_start];
+                token_len = 0;
+            }
+
+            token_start = i + 1;
+        }
+        else
+        {
+            token_len++;
+        }
+    }
+
+    if (token_len)
+    {
+        args[num_args++] = &line[token_start];
+    }
+
+    return num_args;
+}
+
+template <typename Function>
+static void run(const char *name, const std::string &original,
+                std::size_t iterations, Function function)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::string line = original;
+    const char *args[max_args];
+    std::size_t total = 0;
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        line.assign(original);
+        total += function(line.data(), line.size(), args);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() -
+                                                            start);
+
+    std::cout << name << ": " << elapsed.count() / iterations
+              << " ns/line, "
+              << (original.size() * iterations) / elapsed.count()
+              << " bytes/ns (" << total / iterations << " args)"
+              << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t iterations = (argc > 1) ? std::atol(argv[1]) : 200000;
+
+    Tokenizer<> tokenizer;
+    Tokenizer<> quoting(Tokenizer<>::whitespace_delims,
+                        Tokenizer<>::shell_quotes);
+
+    /* A typical command line, then long argument lines. */
+    static constexpr std::pair<std::size_t, std::size_t> shapes[] = {
+        {4, 4}, {4, 48}, {16, 48}, {64, 48}};
+
+    for (auto [word_length, words] : shapes)
+    {
+        std::string line;
+        for (std::size_t i = 0; i < words; i++)
+        {
+            line += std::string(word_length, 'a' + (i % 26)) + "  ";
+        }
+
+        std::cout << "--- " << line.size() << " byte line, " << word_length
+                  << " byte words ---" << std::endl;
+
+        run("legacy", line, iterations,
+            [](char *data, std::size_t size, const char **args) {
+                return legacy_tokenize(data, size, args);
+            });
+        run("tokenizer", line, iterations,
+            [&tokenizer](char *data, std::size_t size, const char **args) {
+                bool overflow;
+                return tokenizer.tokenize(data, size, args, max_args,
+                                          overflow);
+            });
+        run("quoting", line, iterations,
+            [&quoting](char *data, std::size_t size, const char **args) {
+                bool overflow;
+                return quoting.tokenize(data, size, args, max_args, overflow);
+            });
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "cli/BinaryCommandApp.h"
+#include "generated/structs/BufferState.h"
+
+/* Commands and binary logging are commonly used together. */
+#include "logging/BinaryLogger.h"
+
+/* toolchain */
+#include <cassert>
+#include <iostream>
+
+using namespace Coral;
+
+/* A minimal structure with the same interface as generated ones. */
+struct [[gnu::packed]] Ping
+{
+    static constexpr uint16_t id = 100;
+    static constexpr std::size_t size = 4;
+
+    uint32_t sequence;
+
+    using Buffer = byte_array<size>;
+
+    std::size_t encode(Buffer *buffer, std::endian endianness) const
+    {
+        uint32_t value = (endianness == std::endian::native)
+                             ? sequence
+                             : std::byteswap(sequence);
+        std::memcpy(buffer->data(), &value, size);
+        return size;
+    }
+
+    std::size_t decode(const Buffer *buffer, std::endian endianness)
+    {
+        std::memcpy(&sequence, buffer->data(), size);
+        if (endianness != std::endian::native)
+        {
+            sequence = std::byteswap(sequence);
+        }
+        return size;
+    }
+};
+
+PrintfLogger logger;
+
+using App = BinaryCommandApp<>;
+
+static App::Buffer host_to_device;
+static App::Buffer device_to_host;
+
+static int pings = 0;
+static BufferState last_state = {};
+
+static void send_raw(const uint8_t *data, std::size_t size)
+{
+    Cobs::MessageEncoder encoder(data, size);
+    assert(encoder.encode(host_to_device));
+}
+
+int main(void)
+{
+    App device(host_to_device, device_to_host, &logger);
+    App host(device_to_host, host_to_device, &logger);
+
+    /* The device responds to state requests (and counts pings). */
+    device.add_handler<BufferState>(
+        [](const BufferState &request) {
+            BufferState response = request;
+            response.read_count++;
+            response.write_count += 2;
+            return response;
+        },
+        "echo a buffer state");
+    device.add_handler<Ping>([](const Ping &ping) {
+        assert(ping.sequence == uint32_t(pings));
+        pings++;
+    });
+    device.add_handler<Ping>([](const Ping &) { assert(false); });
+    device.help();
+
+    host.add_handler<BufferState>(
+        [](const BufferState &response) { last_state = response; });
+
+    /* Round trip. */
+    BufferState request = {1, 2, 3, 0x01020304};
+    host.send(request);
+    assert(last_state.write_cursor == 1);
+    assert(last_state.read_cursor == 2);
+    assert(last_state.read_count == 4);
+    assert(last_state.write_count == 0x01020306);
+
+    for (int i = 0; i < 10; i++)
+    {
+        host.send(Ping{uint32_t(i)});
+    }
+    assert(pings == 10);
+
+    /* Frames are little endian on the wire. */
+    uint8_t frame[] = {100, 0, 10, 0, 0, 0};
+    send_raw(frame, sizeof(frame));
+    assert(pings == 11);
+
+    /* Unknown and malformed frames are counted. */
+    uint16_t unknown;
+    uint16_t malformed;
+
+    uint8_t unknown_frame[] = {5, 0, 1, 2, 3, 4};
+    send_raw(unknown_frame, sizeof(unknown_frame));
+    send_raw(unknown_frame, 1);
+    send_raw(frame, sizeof(frame) - 1);
+
+    device.poll_metrics(unknown, malformed);
+    assert(unknown == 2);
+    assert(malformed == 1);
+    assert(pings == 11);
+
+    /* Registering past the last slot is refused. */
+    using Small = BinaryCommandApp<1, 16>;
+    static Small::Buffer small_rx;
+    static Small::Buffer small_tx;
+
+    Small small(small_rx, small_tx, &logger);
+    small.add_handler<Ping>([](const Ping &) {});
+    small.add_handler<BufferState>([](const BufferState &) {});
+    small.help();
+
+    /* A frame that never fits is dropped instead of waiting forever. */
+    int services = 0;
+    small_tx.set_data_available([&services](Small::Buffer *) { services++; });
+
+    assert(ToBool(small.send(Ping{1})));
+    assert(ToBool(small.send(Ping{2})));
+
+    services = 0;
+    assert(not small.send(Ping{3}, 4));
+    assert(services == 4);
+    assert(small_tx.state.data_available() == 16);
+
+    /* Draining the buffer makes room again. */
+    small_tx.clear();
+    assert(ToBool(small.send(Ping{4})));
+
+    return 0;
+}
@@ -90,6 +90,113 @@ void test_doubles_basic(Buffer &buffer)
     assert(value);
 }
 
+void test_conversions(Buffer &buffer)
+{
+    (void)buffer;
+
+    Processor proc(buffer, [](const char **argc, std::size_t argv) {
+        CommandLine cli(argc, argv, &logger);
+
+        long long_value;
+        assert(cli.as_long<0>(long_value));
+        assert(long_value == -42);
+
+        /* Base detection. */
+        int int_value;
+        assert(cli.as_integer<1>(int_value));
+        assert(int_value == 0x1f);
+        assert(cli.as_integer<2>(int_value));
+        assert(int_value == 010);
+        assert(cli.as_integer<3>(int_value));
+        assert(int_value == 7);
+
+        /* Range checks. */
+        int8_t small;
+        assert(cli.as_integer<4>(small));
+        assert(small == -128);
+        assert(not cli.as_integer<5>(small));
+
+        uint8_t small_unsigned;
+        assert(cli.as_unsigned<6>(small_unsigned));
+        assert(small_unsigned == 255);
+        assert(not cli.as_unsigned<4>(small_unsigned));
+
+        unsigned long long_unsigned;
+        assert(not cli.as_unsigned<7>(long_unsigned));
+
+        uint32_t hex;
+        assert(cli.as_hex<8>(hex));
+        assert(hex == 0xdeadbeef);
+        assert(cli.as_hex<9>(hex));
+        assert(hex == 0xff);
+        assert(not cli.as_hex<10>(hex));
+
+        /* Fixed point (Q15.16 and Q0.7). */
+        int32_t fixed;
+        assert((cli.as_fixed<11, 16>(fixed)));
+        assert(fixed == -(1 << 16) - 0x4000);
+        assert((cli.as_fixed<12, 16>(fixed)));
+        assert(fixed == 0x8000);
+        assert(not(cli.as_fixed<10, 16>(fixed)));
+
+        int8_t q7;
+        assert((cli.as_fixed<12, 7>(q7)));
+        assert(q7 == 64);
+        assert(not(cli.as_fixed<13, 7>(q7)));
+
+        /* Signs and points alone aren't numbers. */
+        assert(not(cli.as_fixed<15, 16>(fixed)));
+        assert(not(cli.as_fixed<16, 16>(fixed)));
+        assert(not(cli.as_fixed<17, 16>(fixed)));
+        assert(not(cli.as_fixed<18, 16>(fixed)));
+
+        double double_value;
+        assert(cli.as_double<14>(double_value));
+        assert(double_value == 2.5e3);
+
+        value = true;
+    });
+
+    value = false;
+    proc.process("cmd -42 0x1f 010 +7 -128 128 255 99999999999999999999 "
+                 "0xdeadbeef ff 12g -1.25 .5 1.0 +2.5e3 - + . -.");
+    assert(value);
+}
+
+void test_double_formats(void)
+{
+    const char *argv[] = {"cmd", "0x1p3", "-0X1.8p1", "+0x10", "+-1",
+                          "-+1", "--1",   "0x-1",     "0x"};
+    CommandLine cli(argv, 9, &logger);
+
+    /* Hexadecimal floats (with an optional sign). */
+    double output;
+    assert(cli.as_double<0>(output));
+    assert(output == 8.0);
+    assert(cli.as_double<1>(output));
+    assert(output == -3.0);
+    assert(cli.as_double<2>(output));
+    assert(output == 16.0);
+
+    /* Only one sign is allowed (before any prefix). */
+    assert(not cli.as_double<3>(output));
+    assert(not cli.as_double<4>(output));
+    assert(not cli.as_double<5>(output));
+    assert(not cli.as_double<6>(output));
+    assert(not cli.as_double<7>(output));
+}
+
+void test_empty_fixed(void)
+{
+    /* An empty argument (which the tokenizer never produces). */
+    const char *argv[] = {"cmd", ""};
+    CommandLine cli(argv, 2, &logger);
+
+    int32_t fixed = 1;
+    assert(not(cli.as_fixed<0, 16>(fixed)));
+    assert(fixed == 1);
+}
+
 int main(void)
 {
     Buffer buffer;
@@ -97,6 +204,9 @@ int main(void)
     test_bools_basic(buffer);
     test_ints_basic(buffer);
     test_doubles_basic(buffer);
+    test_conversions(buffer);
+    test_double_formats();
+    test_empty_fixed();
 
     return 0;
 }
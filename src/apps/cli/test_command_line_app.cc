@@ -7,20 +7,89 @@
 
 using CommandLine = CommandLineApp::CommandLine;
 
+static int test1_calls = 0;
+static int test2_calls = 0;
+static int other_calls = 0;
+
+static int typed_calls = 0;
+static int last_int = 0;
+static double last_double = 0.0;
+static bool last_bool = false;
+static std::string last_string;
+
+static_assert(std::string_view(
+                  CommandSignature<int, unsigned, double, bool,
+                                   const char *>::usage()) ==
+              "<int> <uint> <float> <bool> <string>");
+static_assert(std::string_view(CommandSignature<>::usage()).empty());
+
 void test1(CommandLine &cli)
 {
     (void)cli;
+    test1_calls++;
 }
 
 void test2(CommandLine &cli)
 {
     (void)cli;
+    test2_calls++;
 }
 
 void register_commands(CommandLineApp &app)
 {
-    app.add_handler("test1", test1);
     app.add_handler("test2", test2, "run the 'test2' method");
+    app.add_handler("test1", test1);
+
+    /* Registered out of order (and a duplicate that's ignored). */
+    app.add_handler("a", [](CommandLine &cli) {
+        (void)cli;
+        other_calls++;
+    });
+    app.add_handler("zzz", [](CommandLine &cli) {
+        (void)cli;
+        other_calls++;
+    });
+    app.add_handler("test1", test2);
+
+    /* Typed commands. */
+    app.add_command<int, double, bool>(
+        "set",
+        [](int a, double b, bool c) {
+            typed_calls++;
+            last_int = a;
+            last_double = b;
+            last_bool = c;
+        },
+        "set some values");
+    app.add_command<std::string_view>("name", [](std::string_view name) {
+        typed_calls++;
+        last_string = name;
+    });
+    app.add_command<>("nothing", []() { typed_calls++; });
+    app.add_command<float>("scale", [](float value) {
+        typed_calls++;
+        last_double = value;
+    });
+}
+
+void test_full(void)
+{
+    /* Room for 'help' and one more command. */
+    using SmallApp = ElementCommandLineApp<2>;
+    SmallApp::Processor::Buffer buffer;
+
+    int calls = 0;
+    SmallApp app(
+        [&calls](SmallApp &small) {
+            small.add_command<>("first", [&calls]() { calls++; });
+            small.add_command<>("second", [&calls]() { calls += 10; });
+        },
+        buffer, &logger);
+
+    /* The command that didn't fit was logged and dropped. */
+    std::stringstream("first\n") >> buffer;
+    std::stringstream("second\n") >> buffer;
+    assert(calls == 1);
 }
 
 int main(void)
@@ -32,10 +101,61 @@ int main(void)
     /* Trigger help. */
     std::stringstream("cmd 123.0 asdf\n") >> buffer;
     std::stringstream("help\n") >> buffer;
+    std::stringstream("test\n") >> buffer;
+    std::stringstream("test11\n") >> buffer;
 
     /* Run commands. */
     std::stringstream("test1\n") >> buffer;
     std::stringstream("test2\n") >> buffer;
+    std::stringstream("test2 a b\n") >> buffer;
+    std::stringstream("a\n") >> buffer;
+    std::stringstream("zzz\n") >> buffer;
+
+    assert(test1_calls == 1);
+    assert(test2_calls == 2);
+    assert(other_calls == 2);
+
+    /* Typed commands. */
+    std::stringstream("help\n") >> buffer;
+    std::stringstream("set -5 2.5 true\n") >> buffer;
+    assert(typed_calls == 1);
+    assert(last_int == -5);
+    assert(last_double == 2.5);
+    assert(last_bool);
+
+    /* Invalid arguments or arity don't call the handler. */
+    std::stringstream("set -5 2.5\n") >> buffer;
+    std::stringstream("set -5 2.5 true extra\n") >> buffer;
+    std::stringstream("set x 2.5 true\n") >> buffer;
+    std::stringstream("set 1 2.5 maybe\n") >> buffer;
+    assert(typed_calls == 1);
+
+    /* Quotes and tabs are only special once enabled. */
+    std::stringstream("name \"a\tb\"\n") >> buffer;
+    assert(typed_calls == 2);
+    assert(last_string == "\"a\tb\"");
+
+    using Tokenizer = CommandLineApp::Processor::Tokenizer;
+    assert(ToBool(app.set_word_delims(Tokenizer::whitespace_delims,
+                                      Tokenizer::shell_quotes)));
+
+    std::stringstream("name\t\"a b\"\n") >> buffer;
+    assert(typed_calls == 3);
+    assert(last_string == "a b");
+
+    std::stringstream("nothing\n") >> buffer;
+    std::stringstream("nothing 1\n") >> buffer;
+    assert(typed_calls == 4);
+
+    /* Values that don't fit a float are rejected (not made infinite). */
+    std::stringstream("scale 1e300\n") >> buffer;
+    std::stringstream("scale -1e300\n") >> buffer;
+    assert(typed_calls == 4);
+    std::stringstream("scale 1.5\n") >> buffer;
+    assert(typed_calls == 5);
+    assert(last_double == 1.5);
+
+    test_full();
 
     return 0;
 }
@@ -0,0 +1,95 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "cli/CommandLineApp.h"
+#include "logging/BufferLogger.h"
+
+/* toolchain */
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Coral;
+
+using TxBuffer = CharBuffer<1024>;
+using Logger = ViewBufferLogger<decltype(buffer_log_handler(
+    std::declval<TxBuffer &>()))>;
+using App = ElementCommandLineApp<default_max_commands, default_max_line,
+                                  default_max_args, char, Logger,
+                                  2 /* max_batch */>;
+
+static App::Processor::Buffer rx;
+static TxBuffer tx;
+static Logger logger(buffer_log_handler(tx));
+
+static std::vector<std::string> executed;
+static std::vector<bool> rx_empty;
+
+static void register_commands(App &app)
+{
+    app.add_command<int>("echo", [](int value) {
+        executed.push_back("echo " + std::to_string(value));
+        rx_empty.push_back(rx.empty());
+        logger.log("echo: %d\n", value);
+    });
+    app.add_command<const char *>("words", [](const char *word) {
+        executed.push_back(std::string("words ") + word);
+    });
+}
+
+static std::string drain(TxBuffer &buffer)
+{
+    std::stringstream stream;
+    stream << buffer;
+    return stream.str();
+}
+
+int main(void)
+{
+    App app(register_commands, rx, &logger);
+    using Tokenizer = App::Processor::Tokenizer;
+    assert(ToBool(app.set_word_delims(Tokenizer::default_delims,
+                                      Tokenizer::shell_quotes)));
+    drain(tx);
+
+    /* Commands run while later lines are still buffered. */
+    std::stringstream("echo 1\necho 2\n") >> rx;
+    assert((executed == std::vector<std::string>{"echo 1", "echo 2"}));
+    assert(not rx_empty[0]);
+
+    /* In batch mode, all input is parsed before anything executes. */
+    executed.clear();
+    rx_empty.clear();
+    app.set_batch_mode();
+
+    std::stringstream("echo 3\n\"words\" a\necho 4\necho 5\necho 6\n") >>
+        rx;
+    assert((executed == std::vector<std::string>{"echo 3", "words a",
+                                                 "echo 4", "echo 5",
+                                                 "echo 6"}));
+
+    /* The queue (two commands) filled up twice. */
+    uint16_t forced;
+    app.poll_metrics(forced);
+    assert(forced == 2);
+    assert(rx_empty.back());
+
+    /* Responses are written in order. */
+    std::string output = drain(tx);
+    std::cout << output;
+    assert(output == "echo: 1\necho: 2\necho: 3\necho: 4\necho: 5\n"
+                     "echo: 6\n");
+
+    /* Back to executing immediately. */
+    executed.clear();
+    app.set_batch_mode(false);
+    std::stringstream("echo 7\necho 8\n") >> rx;
+    assert(executed.size() == 2);
+    assert(not rx_empty[rx_empty.size() - 2]);
+
+    return 0;
+}
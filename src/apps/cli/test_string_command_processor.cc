@@ -52,10 +52,45 @@ int main(void)
     std::stringstream("\n\na    b    c   \n\n") >> buffer;
     assert(proc.poll() == 1);
 
+    /* Several lines (and a partial one) available at once. */
+    std::stringstream("a b c\na b c\na b") >> buffer;
+    assert(proc.poll() == 2);
+    std::stringstream(" c\n") >> buffer;
+    assert(proc.poll() == 1);
+
+    /* Lines that wrap around the end of the buffer. */
+    for (std::size_t i = 0; i < depth / 5; i++)
+    {
+        std::stringstream("a b c\n") >> buffer;
+        assert(proc.poll() == 1);
+    }
+
     proc.process("  a   b   c  ");
     std::string test = "a b c";
     proc.process(test);
 
+    /* Tabs and quoting (once enabled). */
+    processed = false;
+    assert(ToBool(proc.set_word_delims(Processor::Tokenizer::whitespace_delims,
+                                       Processor::Tokenizer::shell_quotes)));
+    proc.process("\ta\t\"b\" 'c'\r");
+    assert(processed);
+
+    /* Lines with too many arguments are dropped. */
+    uint16_t overflows;
+    processed = false;
+    std::string many;
+    for (std::size_t i = 0; i <= default_max_args; i++)
+    {
+        many += "x ";
+    }
+    proc.process(many);
+    assert(not processed);
+    proc.poll_metrics(overflows);
+    assert(overflows == 1);
+    proc.poll_metrics(overflows);
+    assert(overflows == 0);
+
     /* Test automatic polling. */
     processed = false;
     Processor new_proc =
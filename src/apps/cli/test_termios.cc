@@ -4,6 +4,7 @@
 
 /* internal */
 #include "cli/Termios.h"
+#include "cli/termios2.h"
 #include "cli/termios_util.h"
 #include "cli/text.h"
 #include "io/file_descriptors.h"
@@ -14,7 +15,9 @@
 #include <unistd.h>
 
 /* toolchain */
+#include <algorithm>
 #include <csignal>
+#include <cstring>
 
 namespace Coral
 {
@@ -158,6 +161,121 @@ static void test_termios(void)
     assert(output == B4000000);
 }
 
+static void test_custom_baud(void)
+{
+    int term_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    assert(term_fd != -1);
+
+    Termios term(term_fd);
+    uint32_t input;
+    uint32_t output;
+
+    /* Standard rates. */
+    assert(term.set_baud(3000000));
+    assert(term.get_baud(input, output));
+    assert(input == 3000000 and output == 3000000);
+
+    /* Non-standard rates (retained when other attributes change). */
+    assert(term.set_baud(12000000));
+    assert(term.get_baud(input, output));
+    assert(input == 12000000 and output == 12000000);
+
+    assert(term.set_echo(false));
+    assert(term.get_baud(input, output));
+    assert(input == 12000000 and output == 12000000);
+
+    assert(not term.set_baud(-1));
+
+    /* Low-latency configuration (no serial driver on a pseudoterminal). */
+    assert(term.set_low_latency(64, 1));
+    assert(not(term.current.c_cflag & CRTSCTS));
+    assert(term.current.c_cc[VMIN] == 64);
+    assert(term.current.c_cc[VTIME] == 1);
+    assert(not(term.current.c_lflag & ICANON));
+    assert(term.get_baud(input, output));
+    assert(output == 12000000);
+
+    /* Flow control is only enabled on request. */
+    assert(term.set_low_latency(64, 1, true));
+    assert(term.current.c_cflag & CRTSCTS);
+    assert(term.set_flow_control(false));
+    assert(not(term.current.c_cflag & CRTSCTS));
+
+    bool low_latency;
+    assert(not get_serial_low_latency(term_fd, low_latency));
+
+    assert(not set_serial_low_latency(term_fd));
+
+    /* Standard rates take over again. */
+    assert(term.set_baud(115200));
+    assert(term.set_echo(false));
+    assert(term.get_baud(input, output));
+    assert(output == 115200);
+}
+
+static void test_transaction(void)
+{
+    int term_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    assert(term_fd != -1);
+
+    Termios term(term_fd);
+    uint16_t applied;
+    uint16_t skipped;
+
+    /* Several changes are applied at once. */
+    term.begin();
+    assert(term.set_echo(false));
+    assert(term.set_canonical(false));
+
+    /* Nested transactions only apply when the outermost commits. */
+    term.begin();
+    assert(term.set_read_timing(8, 1));
+    assert(term.commit());
+
+    term.poll_metrics(applied, skipped);
+    assert(applied == 0 and skipped == 0);
+
+    assert(term.commit());
+    term.poll_metrics(applied, skipped);
+    assert(applied == 1 and skipped == 0);
+
+    struct termios data;
+    assert(tcgetattr(term_fd, &data) == 0);
+    assert(not(data.c_lflag & (ECHO | ICANON)));
+    assert(data.c_cc[VMIN] == 8 and data.c_cc[VTIME] == 1);
+
+    /* Unchanged settings aren't applied again. */
+    assert(term.set_echo(false));
+    assert(term.set_read_timing(8, 1));
+    term.poll_metrics(applied, skipped);
+    assert(applied == 0 and skipped == 2);
+
+    /* Settings are compared field by field. */
+    struct termios copy;
+    std::memset(&copy, 0xff, sizeof(copy));
+    copy.c_iflag = data.c_iflag;
+    copy.c_oflag = data.c_oflag;
+    copy.c_cflag = data.c_cflag;
+    copy.c_lflag = data.c_lflag;
+    copy.c_line = data.c_line;
+    std::copy(std::begin(data.c_cc), std::end(data.c_cc), copy.c_cc);
+    assert(cfsetispeed(&copy, cfgetispeed(&data)) == 0);
+    assert(cfsetospeed(&copy, cfgetospeed(&data)) == 0);
+    assert(same_settings(copy, data));
+
+    copy.c_cc[VMIN]++;
+    assert(not same_settings(copy, data));
+    copy.c_cc[VMIN]--;
+    assert(cfsetospeed(&copy, B9600) == 0);
+    assert(not same_settings(copy, data));
+
+    /* Baud-rate changes are still applied. */
+    assert(term.set_baud(12000000));
+    assert(term.set_baud(12000000));
+    term.poll_metrics(applied, skipped);
+    assert(applied == 1 and skipped == 1);
+}
+
 } // namespace Coral
 
 int main(void)
@@ -168,6 +286,8 @@ int main(void)
 
     test_text();
     test_termios();
+    test_custom_baud();
+    test_transaction();
 
     return 0;
 }
@@ -0,0 +1,126 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "cli/Tokenizer.h"
+
+/* toolchain */
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Coral;
+
+static std::vector<std::string> tokenize(const Tokenizer<> &tokenizer,
+                                         std::string line,
+                                         std::size_t max_args,
+                                         bool &overflow)
+{
+    std::vector<const char *> args(max_args);
+    std::size_t count = tokenizer.tokenize(line.data(), line.size(),
+                                           args.data(), max_args, overflow);
+
+    std::vector<std::string> result;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::cout << "'" << args[i] << "' ";
+        result.emplace_back(args[i]);
+    }
+    std::cout << std::endl;
+
+    return result;
+}
+
+/* Tokenize with whitespace delimiters and quoting enabled. */
+static std::vector<std::string> tokenize(std::string line)
+{
+    bool overflow;
+    Tokenizer<> tokenizer(Tokenizer<>::whitespace_delims,
+                          Tokenizer<>::shell_quotes);
+    auto result = tokenize(tokenizer, line, 32, overflow);
+    assert(not overflow);
+    return result;
+}
+
+using Tokens = std::vector<std::string>;
+
+int main(void)
+{
+    /* Whitespace. */
+    assert(tokenize("") == Tokens{});
+    assert(tokenize(" \t\r ") == Tokens{});
+    assert(tokenize("a b c") == (Tokens{"a", "b", "c"}));
+    assert(tokenize(" \ta\t\tb \r c\r") == (Tokens{"a", "b", "c"}));
+
+    /* Quoting. */
+    assert(tokenize("say \"hello world\" 'a \"b\" c'") ==
+           (Tokens{"say", "hello world", "a \"b\" c"}));
+    assert(tokenize("a\"b c\"d e") == (Tokens{"ab cd", "e"}));
+    assert(tokenize("\"\" ''") == (Tokens{"", ""}));
+    assert(tokenize("a \"unterminated quote") ==
+           (Tokens{"a", "unterminated quote"}));
+
+    /* Tokens long enough to be scanned in blocks. */
+    std::string long_token(100, 'x');
+    std::string line = long_token + " \"" + long_token + " " + long_token +
+                       "\"" + long_token + "\t" + long_token;
+    assert(tokenize(line) == (Tokens{long_token,
+                                     long_token + " " + long_token +
+                                         long_token,
+                                     long_token}));
+
+    for (std::size_t i = 1; i < 40; i++)
+    {
+        line = std::string(i, 'a') + " " + std::string(40 - i, 'b');
+        assert(tokenize(line) ==
+               (Tokens{std::string(i, 'a'), std::string(40 - i, 'b')}));
+    }
+
+    /* By default, only spaces are special. */
+    bool overflow;
+    Tokenizer<> tokenizer;
+    assert(tokenize(tokenizer, " a\tb  \"c d\" 'e'\r", 8, overflow) ==
+           (Tokens{"a\tb", "\"c", "d\"", "'e'\r"}));
+    line = std::string(20, 'a') + "  " + std::string(8, 'b') + " " +
+           std::string(7, 'c');
+    assert(tokenize(tokenizer, line, 8, overflow) ==
+           (Tokens{std::string(20, 'a'), std::string(8, 'b'),
+                   std::string(7, 'c')}));
+
+    /* Too many arguments. */
+    assert(tokenize(tokenizer, "a b c", 3, overflow).size() == 3);
+    assert(not overflow);
+    assert(tokenize(tokenizer, "a b c d", 3, overflow).size() == 3);
+    assert(overflow);
+
+    /* Custom delimiters (and no quoting). */
+    tokenizer.configure(",", "");
+    assert(tokenize(tokenizer, "a b,,\"c\",d", 8, overflow) ==
+           (Tokens{"a b", "\"c\"", "d"}));
+
+    /* Without special elements, even null elements are ordinary. */
+    assert(ToBool(tokenizer.configure("", "")));
+    line = std::string(20, 'x');
+    line[10] = '\0';
+    auto tokens = tokenize(tokenizer, line, 8, overflow);
+    assert(tokens.size() == 1);
+
+    /* At most 'max_token_specials' special elements can be configured. */
+    assert(ToBool(tokenizer.configure(" \t\r\n,;", "\"'")));
+    assert(not tokenizer.configure(" \t\r\n,;:", "\"'"));
+    assert(tokenize(tokenizer, "a:b;'c'", 8, overflow) ==
+           (Tokens{"a", "b", "'c'"}));
+
+    /* Wider elements. */
+    Tokenizer<wchar_t> wide(Tokenizer<wchar_t>::default_delims,
+                            Tokenizer<wchar_t>::shell_quotes);
+    std::wstring wline = L"x \"y z\"";
+    const wchar_t *wargs[4];
+    assert(wide.tokenize(wline.data(), wline.size(), wargs, 4, overflow) ==
+           2);
+    assert(std::wstring(wargs[1]) == L"y z");
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * Serial-stack loopback benchmark over a pseudoterminal pair.
+ *
+ * usage: pty_loopback [FRAMES] [PAYLOAD_BYTES] [WINDOW] [COALESCE_BYTES]
+ *                     [DEADLINE_US] [TIMEOUT_S]
+ *
+ * The primary end sends COBS-framed messages (up to WINDOW in flight) that
+ * the secondary end decodes and echoes back. Reports throughput and
+ * round-trip latency percentiles. With COALESCE_BYTES, both ends hold
+ * transmit data until that much is buffered (or DEADLINE_US passes). The run
+ * fails if every frame hasn't come back within TIMEOUT_S seconds.
+ */
+
+/* internal */
+#include "buffer/cobs/Decoder.h"
+#include "buffer/cobs/Encoder.h"
+#include "cli/Termios.h"
+#include "io/FdBuffer.h"
+#include "io/Pty.h"
+
+/* toolchain */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/* linux */
+#include <poll.h>
+
+using namespace Coral;
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr std::size_t depth = 4096;
+static constexpr std::size_t mtu = 1024;
+
+using Buffer = FdBuffer<depth, depth>;
+using Decoder = Cobs::MessageDecoder<mtu>;
+
+/* Encode a frame, servicing both ends while the output is full. */
+static bool encode(const uint8_t *data, std::size_t size, Buffer &output,
+                   std::function<void()> service, Clock::time_point give_up)
+{
+    Cobs::MessageEncoder encoder(data, size);
+    while (not encoder.encode(output.tx))
+    {
+        if (Clock::now() >= give_up)
+        {
+            return false;
+        }
+        service();
+    }
+    return true;
+}
+
+/*
+ * Wait (up to 'timeout') until either end can make progress: data to read,
+ * or room to write data that isn't being held back for coalescing.
+ */
+static void wait(Buffer &host, Buffer &device, bool coalescing,
+                 Clock::duration timeout)
+{
+    auto events = [coalescing](Buffer &buffer) -> short {
+        bool writable = buffer.tx.full() or
+                        (not coalescing and not buffer.tx.empty());
+        return POLLIN | ((writable) ? POLLOUT : 0);
+    };
+
+    struct pollfd fds[] = {{host.fd, events(host), 0},
+                           {device.fd, events(device), 0}};
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout);
+    struct timespec ts = {time_t(ns.count() / 1000000000),
+                          long(ns.count() % 1000000000)};
+
+    ppoll(fds, 2, &ts, nullptr);
+}
+
+static double percentile(const std::vector<double> &sorted, double rank)
+{
+    std::size_t index = rank * (sorted.size() - 1);
+    return sorted[index];
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t frames = (argc > 1) ? std::atol(argv[1]) : 10000;
+    std::size_t payload = (argc > 2) ? std::atol(argv[2]) : 64;
+    std::size_t window = (argc > 3) ? std::atol(argv[3]) : 1;
+    std::size_t coalesce = (argc > 4) ? std::atol(argv[4]) : 0;
+    uint32_t deadline = (argc > 5) ? std::atol(argv[5]) : 100;
+    long timeout = (argc > 6) ? std::atol(argv[6]) : 10;
+
+    payload = std::clamp<std::size_t>(payload, sizeof(uint32_t), mtu);
+    window = std::max<std::size_t>(window, 1);
+
+    PseudoTerminal pty;
+    if (not pty.valid())
+    {
+        std::cerr << "Couldn't open a pseudoterminal." << std::endl;
+        return 1;
+    }
+
+    Termios primary_term(pty.primary, false);
+    Termios secondary_term(pty.secondary, false);
+    primary_term.set_low_latency();
+    secondary_term.set_low_latency();
+
+    Buffer host(pty.primary);
+    Buffer device(pty.secondary);
+    host.set_coalescing(coalesce, deadline);
+    device.set_coalescing(coalesce, deadline);
+
+    std::vector<Clock::time_point> sent_at(frames);
+    std::vector<double> latencies;
+    latencies.reserve(frames);
+
+    std::size_t sent = 0;
+    std::size_t received = 0;
+    std::size_t errors = 0;
+
+    Clock::time_point give_up;
+
+    Decoder host_decoder([&](const std::array<uint8_t, mtu> &data,
+                             std::size_t size) {
+        uint32_t sequence;
+        std::memcpy(&sequence, data.data(), sizeof(sequence));
+
+        if (size != payload or sequence >= frames)
+        {
+            errors++;
+            return;
+        }
+
+        std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - sent_at[sequence];
+        latencies.push_back(elapsed.count());
+        received++;
+    });
+
+    auto service_host = [&]() {
+        host.dispatch();
+        host_decoder.dispatch(host.rx);
+    };
+
+    /* The device echoes every frame. */
+    Decoder device_decoder([&](const std::array<uint8_t, mtu> &data,
+                               std::size_t size) {
+        if (not encode(
+                data.data(), size, device,
+                [&]() {
+                    device.dispatch();
+                    service_host();
+                },
+                give_up))
+        {
+            errors++;
+        }
+    });
+
+    auto service = [&]() {
+        device.dispatch();
+        device_decoder.dispatch(device.rx);
+        service_host();
+    };
+
+    /* Non-zero filler (with some zeros) exercises COBS encoding. */
+    std::vector<uint8_t> frame(payload);
+    for (std::size_t i = 0; i < payload; i++)
+    {
+        frame[i] = i % 64;
+    }
+
+    /* Held data only needs servicing once its deadline passes. */
+    Clock::duration idle = std::chrono::milliseconds(100);
+    if (coalesce)
+    {
+        idle = std::min(idle, Clock::duration(
+                                  std::chrono::microseconds(deadline)));
+    }
+
+    auto start = Clock::now();
+    give_up = start + std::chrono::seconds(timeout);
+
+    while (received + errors < frames)
+    {
+        auto now = Clock::now();
+        if (now >= give_up)
+        {
+            std::cerr << "Timed out after " << timeout << " s (" << received
+                      << " of " << frames << " frames received)."
+                      << std::endl;
+            return 1;
+        }
+
+        while (sent < frames and sent - received - errors < window)
+        {
+            uint32_t sequence = sent;
+            std::memcpy(frame.data(), &sequence, sizeof(sequence));
+
+            sent_at[sent++] = Clock::now();
+            if (not encode(frame.data(), frame.size(), host, service,
+                           give_up))
+            {
+                break;
+            }
+        }
+
+        service();
+
+        /* Sleep until there's more to do (instead of spinning). */
+        bool can_send = sent < frames and sent - received - errors < window;
+        if (received + errors < frames and not can_send)
+        {
+            wait(host, device, coalesce, std::min(idle, give_up - now));
+        }
+    }
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    uint32_t reads;
+    uint32_t writes;
+    uint16_t io_errors;
+    host.poll_metrics(reads, writes, io_errors);
+
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << "frames: " << frames << " (" << payload
+              << " byte payload, window " << window << ", " << errors
+              << " errors)" << std::endl;
+    if (coalesce)
+    {
+        std::cout << "coalescing: " << coalesce << " bytes, " << deadline
+                  << " us deadline" << std::endl;
+    }
+    std::cout << "frames/s: " << received / elapsed.count() << std::endl;
+    std::cout << "bytes/s: " << (received * payload) / elapsed.count()
+              << " (payload, each direction)" << std::endl;
+    std::cout << "host syscalls/frame: " << double(reads + writes) / frames
+              << std::endl;
+
+    if (not latencies.empty())
+    {
+        std::cout << "round trip (us): p50 " << percentile(latencies, 0.5)
+                  << ", p99 " << percentile(latencies, 0.99) << ", p999 "
+                  << percentile(latencies, 0.999) << ", max "
+                  << latencies.back() << std::endl;
+    }
+
+    return (errors) ? 1 : 0;
+}
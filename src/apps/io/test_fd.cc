@@ -3,9 +3,22 @@
 
 /**/
 #include <cassert>
+#include <cstdlib>
+#include <string>
 
 /* linux */
 #include <fcntl.h>
+#include <unistd.h>
+
+/* Create an empty temporary file (and get its path). */
+static std::string temp_path(void)
+{
+    char path[] = "/tmp/test_fd_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+    return path;
+}
 
 int main(void)
 {
@@ -17,7 +30,7 @@ int main(void)
 
     {
         FdManager fds;
-        char *path = std::tmpnam(nullptr);
+        std::string path = temp_path();
         assert(fds.add_file_fd(path, "wb+"));
         int fd = fds[path];
 
@@ -31,6 +44,67 @@ int main(void)
 
         fd_set_blocking_state(fd, true);
         fd_set_blocking_state(fd, false);
+
+        /* Explicit flags. */
+        std::string other = temp_path();
+        assert(fds.add_file_fd(other, O_RDWR | O_CREAT | O_CLOEXEC |
+                                          O_NONBLOCK));
+        fd = fds[other];
+        assert(fcntl(fd, F_GETFD) & FD_CLOEXEC);
+        assert(fcntl(fd, F_GETFL) & O_NONBLOCK);
+
+        /* Flags track blocking-state changes made by the manager. */
+        FdFlags flags;
+        assert(fds.flags(fd, flags));
+        assert(flags.status & O_NONBLOCK);
+        assert(flags.descriptor & FD_CLOEXEC);
+        assert(fds.fd_info(fd));
+
+        assert(fds.set_blocking_state(fd, true));
+        assert(not(fcntl(fd, F_GETFL) & O_NONBLOCK));
+        assert(fds.flags(fd, flags));
+        assert(not(flags.status & O_NONBLOCK));
+
+        assert(fds.set_blocking_state(fd, false));
+        assert(fcntl(fd, F_GETFL) & O_NONBLOCK);
+        assert(fds.flags(fd, flags));
+        assert(flags.status & O_NONBLOCK);
+
+        /* Cached flags don't outlive the descriptor (numbers are reused). */
+        assert(fds.close_fd(other));
+        assert(not fds.close_fd(other));
+        assert(fds.add_file_fd(other, O_RDWR));
+        assert(fds[other] == fd);
+        assert(fds.flags(fd, flags));
+        assert(not(flags.status & O_NONBLOCK));
+        assert(not(flags.descriptor & FD_CLOEXEC));
+
+        /* Flags aren't needed to change the blocking state. */
+        assert(fds.set_blocking_state(fd, false));
+        assert(fcntl(fd, F_GETFL) & O_NONBLOCK);
+        assert(fds.flags(fd, flags));
+        assert(flags.status & O_NONBLOCK);
+        assert(not(flags.descriptor & FD_CLOEXEC));
+
+        unlink(path.c_str());
+        unlink(other.c_str());
+    }
+
+    /* Mode strings. */
+    assert(open_flags("r") == O_RDONLY);
+    assert(open_flags("r+") == O_RDWR);
+    assert(open_flags("wb") == (O_WRONLY | O_CREAT | O_TRUNC));
+    assert(open_flags("a+e") == (O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC));
+    assert(open_flags("wx") == (O_WRONLY | O_CREAT | O_TRUNC | O_EXCL));
+    assert(open_flags("q") == -1);
+    assert(open_flags("rz") == -1);
+
+    {
+        FdMap fds;
+        assert(not get_file_fd("/nonexistent/file", fds));
+        assert(not get_file_fd("/dev/null", fds, "?"));
+        assert(get_file_fd("/dev/null", fds, "re"));
+        close_fds(fds);
     }
 
     return 0;
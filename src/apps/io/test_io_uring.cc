@@ -0,0 +1,114 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* linux */
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* internal */
+#include "io/UringBackend.h"
+
+/* toolchain */
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 256;
+using Backend = UringBackend<depth, depth>;
+
+/* Destroying a backend cancels reads still waiting for data. */
+void test_cancel(void)
+{
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    {
+        Backend backend({{"a", fds[0]}});
+        assert(backend.valid());
+        backend.poll();
+    }
+
+    /* Nothing was read on the destroyed backend's behalf. */
+    const char message[] = "hello";
+    assert(write(fds[1], message, sizeof(message)) == sizeof(message));
+
+    char data[sizeof(message)];
+    assert(read(fds[0], data, sizeof(data)) == sizeof(data));
+    assert(std::memcmp(data, message, sizeof(data)) == 0);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+int main(void)
+{
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    FdMap group = {{"a", fds[0]}, {"b", fds[1]}};
+
+    Backend backend(group);
+    assert(backend.valid());
+    std::cout << "registered: " << backend.registered() << std::endl;
+
+    auto &a = backend["a"];
+    auto &b = backend["b"];
+
+    /* Data moves in both directions (more than either buffer holds). */
+    std::size_t total = depth * 8;
+    std::size_t sent = 0;
+    std::size_t received_a = 0;
+    std::size_t received_b = 0;
+
+    while (received_a < total or received_b < total)
+    {
+        while (sent < total and not a.tx.full() and not b.tx.full())
+        {
+            uint8_t value = sent++;
+            assert(a.tx.push(value));
+            assert(b.tx.push(value));
+        }
+
+        backend.poll(1);
+
+        uint8_t value;
+        while (ToBool(b.rx.pop(value)))
+        {
+            assert(value == uint8_t(received_b++));
+        }
+        while (ToBool(a.rx.pop(value)))
+        {
+            assert(value == uint8_t(received_a++));
+        }
+    }
+
+    /* Closing one end is reported at the other. */
+    shutdown(fds[0], SHUT_WR);
+    for (int i = 0; i < 100 and not b.closed(); i++)
+    {
+        backend.poll(1);
+    }
+    assert(b.closed());
+
+    uint16_t errors;
+    a.poll_metrics(errors);
+    assert(errors == 0);
+    b.poll_metrics(errors);
+    assert(errors == 0);
+
+    uint32_t enters;
+    uint32_t completions;
+    backend.poll_metrics(enters, completions);
+    std::cout << "enters: " << enters << ", completions: " << completions
+              << std::endl;
+    assert(enters > 0 and completions >= enters);
+
+    close_fds(group);
+
+    test_cancel();
+
+    return 0;
+}
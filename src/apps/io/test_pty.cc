@@ -0,0 +1,69 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "buffer/cobs/Decoder.h"
+#include "buffer/cobs/Encoder.h"
+#include "cli/Termios.h"
+#include "io/FdBuffer.h"
+#include "io/Pty.h"
+
+/* toolchain */
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace Coral;
+
+static constexpr std::size_t depth = 256;
+using Buffer = FdBuffer<depth, depth>;
+
+int main(void)
+{
+    PseudoTerminal pty;
+    assert(pty.valid());
+    std::cout << pty.path << std::endl;
+
+    Termios primary_term(pty.primary, false);
+    Termios secondary_term(pty.secondary, false);
+    assert(primary_term.set_low_latency());
+    assert(secondary_term.set_low_latency());
+
+    Buffer primary(pty.primary);
+    Buffer secondary(pty.secondary);
+
+    /* Frames written to one end arrive at the other. */
+    std::size_t received = 0;
+    Cobs::MessageDecoder<depth> decoder(
+        [&received](const std::array<uint8_t, depth> &data,
+                    std::size_t size) {
+            assert(size == 5);
+            assert(std::memcmp(data.data(), "ab\0cd", size) == 0);
+            received++;
+        });
+
+    for (int i = 0; i < 10; i++)
+    {
+        Cobs::MessageEncoder encoder("ab\0cd", 5);
+        assert(encoder.encode(primary.tx));
+    }
+
+    for (int attempts = 0; attempts < 1000 and received < 10; attempts++)
+    {
+        primary.dispatch();
+        secondary.dispatch();
+        decoder.dispatch(secondary.rx);
+    }
+    assert(received == 10);
+
+    uint32_t reads;
+    uint32_t writes;
+    uint16_t errors;
+    primary.poll_metrics(reads, writes, errors);
+    assert(writes > 0 and errors == 0);
+    secondary.poll_metrics(reads, writes, errors);
+    assert(reads > 0 and errors == 0);
+
+    return 0;
+}
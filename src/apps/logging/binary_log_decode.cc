@@ -0,0 +1,116 @@
+/*
+ * Reconstruct text from binary log records (see logging/BinaryLogger.h).
+ *
+ * usage: binary_log_decode [-c] [FILE]
+ *
+ *   -c  input records are COBS framed
+ *
+ * Reads standard input if no file is provided.
+ */
+
+/* internal */
+#include "buffer/PcBuffer.h"
+#include "buffer/cobs/Decoder.h"
+#include "logging/BinaryLog.h"
+
+/* toolchain */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+using namespace Coral;
+
+static constexpr std::size_t frame_mtu = 1 << 16;
+
+static int decode_raw(const std::vector<uint8_t> &data,
+                      BinaryLog::Decoder &decoder)
+{
+    std::size_t index = 0;
+
+    while (index < data.size())
+    {
+        std::size_t consumed =
+            decoder.decode(&data[index], data.size() - index);
+        if (not consumed)
+        {
+            std::cerr << "Invalid or incomplete record at offset " << index
+                      << "." << std::endl;
+            return 1;
+        }
+        index += consumed;
+    }
+
+    return 0;
+}
+
+static int decode_cobs(const std::vector<uint8_t> &data,
+                       BinaryLog::Decoder &decoder)
+{
+    using Buffer = PcBuffer<BUFSIZ, uint8_t>;
+    using Frames = Cobs::MessageDecoder<frame_mtu>;
+
+    int result = 0;
+
+    /* Large enough that it shouldn't live on the stack. */
+    auto frames = std::make_unique<Frames>(
+        [&decoder, &result](const std::array<uint8_t, frame_mtu> &frame,
+                            std::size_t size) {
+            if (decoder.decode(frame.data(), size) != size)
+            {
+                std::cerr << "Invalid frame (" << size << " bytes)."
+                          << std::endl;
+                result = 1;
+            }
+        });
+
+    Buffer buffer;
+
+    std::size_t index = 0;
+    while (index < data.size())
+    {
+        index += buffer.try_push_n(&data[index], data.size() - index);
+        frames->dispatch(buffer);
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    bool cobs = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "-c") == 0)
+        {
+            cobs = true;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    std::ifstream file;
+    if (path)
+    {
+        file.open(path, std::ios::binary);
+        if (not file)
+        {
+            std::cerr << "Couldn't open '" << path << "'." << std::endl;
+            return 1;
+        }
+    }
+    std::istream &input = (path) ? file : std::cin;
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)),
+                              std::istreambuf_iterator<char>());
+
+    BinaryLog::Decoder decoder;
+    return (cobs) ? decode_cobs(data, decoder) : decode_raw(data, decoder);
+}
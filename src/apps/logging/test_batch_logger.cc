@@ -0,0 +1,272 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "logging/BatchLogger.h"
+
+/* toolchain */
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/* linux */
+#include <unistd.h>
+
+using namespace Coral;
+
+static constexpr int num_threads = 4;
+static constexpr int num_lines = 200;
+
+static std::string read_all(FILE *file)
+{
+    std::string result;
+
+    int fd = fileno(file);
+    lseek(fd, 0, SEEK_SET);
+
+    char chunk[BUFSIZ];
+    ssize_t count;
+    while ((count = read(fd, chunk, sizeof(chunk))) > 0)
+    {
+        result.append(chunk, count);
+    }
+
+    return result;
+}
+
+static void test_threads(void)
+{
+    FILE *file = std::tmpfile();
+    assert(file);
+
+    {
+        /* Only flush explicitly (or when buffers fill). */
+        FdBatchLogger logger(fileno(file), default_batch_depth * num_threads,
+                             std::chrono::hours(1));
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; i++)
+        {
+            threads.emplace_back([&logger, i]() {
+                for (int j = 0; j < num_lines; j++)
+                {
+                    logger.log("thread %d line %d\n", i, j);
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        assert(logger.flush());
+
+        uint32_t writes;
+        uint32_t records;
+        uint16_t truncated;
+        logger.poll_metrics(writes, records, truncated);
+        std::cout << writes << " write(s) for " << records << " record(s)."
+                  << std::endl;
+        assert(records == num_threads * num_lines);
+        assert(writes < records);
+        assert(truncated == 0);
+    }
+
+    /* Every line is present and in order per thread. */
+    std::istringstream stream(read_all(file));
+    std::string line;
+    int expected[num_threads] = {};
+    int total = 0;
+    while (std::getline(stream, line))
+    {
+        int thread;
+        int index;
+        assert(sscanf(line.c_str(), "thread %d line %d", &thread, &index) ==
+               2);
+        assert(index == expected[thread]);
+        expected[thread]++;
+        total++;
+    }
+    assert(total == num_threads * num_lines);
+
+    std::fclose(file);
+}
+
+static void test_thresholds(void)
+{
+    FILE *file = std::tmpfile();
+    assert(file);
+
+    uint32_t writes;
+    uint32_t records;
+    uint16_t truncated;
+
+    /* Size threshold. */
+    {
+        FdBatchLogger logger(fileno(file), 8, std::chrono::hours(1));
+
+        logger.log("1234");
+        logger.poll_metrics(writes, records, truncated);
+        assert(writes == 0);
+
+        logger.log("5678");
+        logger.poll_metrics(writes, records, truncated);
+        assert(writes == 1);
+        assert(records == 2);
+    }
+
+    /* Time threshold. */
+    {
+        FdBatchLogger logger(fileno(file), default_batch_depth,
+                             std::chrono::milliseconds(1));
+
+        logger.log("abcd");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        logger.dispatch();
+
+        logger.poll_metrics(writes, records, truncated);
+        assert(writes == 1);
+        assert(records == 1);
+
+        /* Nothing pending. */
+        logger.dispatch();
+        logger.poll_metrics(writes, records, truncated);
+        assert(writes == 0);
+    }
+
+    /* Oversized records are truncated. */
+    {
+        FdBatchLogger logger(fileno(file));
+
+        std::string large(default_batch_depth * 2, 'x');
+        logger.log("%s", large.c_str());
+        logger.log("%s", large.c_str());
+        logger.flush();
+
+        logger.poll_metrics(writes, records, truncated);
+        assert(records == 2);
+        assert(truncated == 2);
+    }
+
+    assert(read_all(file).starts_with("12345678abcdxxx"));
+
+    std::fclose(file);
+}
+
+static void test_background_flush(void)
+{
+    FILE *file = std::tmpfile();
+    assert(file);
+
+    uint32_t writes;
+    uint32_t records;
+    uint16_t truncated;
+
+    {
+        FdBatchLogger logger(fileno(file), default_batch_depth,
+                             std::chrono::milliseconds(5));
+
+        /* A thread that logs once and goes quiet still gets written. */
+        std::thread([&logger]() { logger.log("quiet\n"); }).join();
+
+        for (int i = 0; i < 100 and read_all(file).empty(); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert(read_all(file) == "quiet\n");
+
+        logger.poll_metrics(writes, records, truncated);
+        assert(records == 1);
+    }
+
+    /* Write errors are reported (after the logger's locks are released). */
+    {
+        int fd = dup(fileno(file));
+        assert(fd != -1);
+        assert(close(fd) == 0);
+
+        FdBatchLogger logger(fd, default_batch_depth, std::chrono::hours(1),
+                             false /* background_flush */);
+        logger.log("lost\n");
+        assert(not logger.flush());
+    }
+
+    std::fclose(file);
+}
+
+/* Exposes the registered per-thread buffers. */
+class InspectLogger : public FdBatchLogger
+{
+  public:
+    using FdBatchLogger::FdBatchLogger;
+
+    std::size_t buffers(void)
+    {
+        std::lock_guard<std::mutex> guard(threads_lock);
+        return threads.size();
+    }
+};
+
+static void test_thread_exit(void)
+{
+    FILE *file = std::tmpfile();
+    assert(file);
+
+    {
+        InspectLogger logger(fileno(file), default_batch_depth,
+                             std::chrono::hours(1));
+
+        /* Short-lived threads (one at a time) reuse the same buffer. */
+        for (int i = 0; i < 8; i++)
+        {
+            std::thread([&logger, i]() {
+                logger.log("thread %d\n", i);
+            }).join();
+            assert(logger.buffers() == 1);
+        }
+
+        /* Exited threads' buffers are freed once written. */
+        assert(logger.flush());
+        assert(logger.buffers() == 0);
+
+        /* A thread can alternate between loggers (and outlive one). */
+        std::thread([&logger, &file]() {
+            for (int i = 0; i < 3; i++)
+            {
+                InspectLogger other(fileno(file));
+                other.log("other %d\n", i);
+                logger.log("logger %d\n", i);
+                assert(other.buffers() == 1);
+            }
+            assert(logger.buffers() == 1);
+        }).join();
+
+        assert(logger.flush());
+        assert(logger.buffers() == 0);
+    }
+
+    std::string text = read_all(file);
+    for (int i = 0; i < 8; i++)
+    {
+        assert(text.find("thread " + std::to_string(i)) != text.npos);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        assert(text.find("other " + std::to_string(i)) != text.npos);
+        assert(text.find("logger " + std::to_string(i)) != text.npos);
+    }
+
+    std::fclose(file);
+}
+
+int main(void)
+{
+    test_threads();
+    test_thresholds();
+    test_background_flush();
+    test_thread_exit();
+    return 0;
+}
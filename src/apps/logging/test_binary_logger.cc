@@ -0,0 +1,163 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "buffer/cobs/Decoder.h"
+#include "logging/BinaryLogger.h"
+
+/* toolchain */
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <vector>
+
+using namespace Coral;
+
+static std::vector<uint8_t> output;
+static std::size_t num_records = 0;
+
+static void handler(const uint8_t *data, std::size_t size)
+{
+    output.insert(output.end(), data, data + size);
+    num_records++;
+}
+
+static std::string decode_all(const std::vector<uint8_t> &data)
+{
+    BinaryLog::Decoder decoder;
+    std::stringstream stream;
+
+    std::size_t index = 0;
+    while (index < data.size())
+    {
+        std::size_t consumed =
+            decoder.decode(&data[index], data.size() - index, stream);
+        assert(consumed);
+        index += consumed;
+    }
+
+    return stream.str();
+}
+
+static void test_round_trip(void)
+{
+    BinaryLogger logger(handler);
+
+    const char *fmt = "%s:%d value=%.2f count=%zu hex=0x%04x %%\n";
+
+    for (int i = 0; i < 3; i++)
+    {
+        logger.log(fmt, "file.cc", 10 + i, 1.5 * i, std::size_t(i), 0xab);
+    }
+
+    /* One format definition, then one record per call. */
+    assert(num_records == 4);
+
+    std::string text = decode_all(output);
+    std::cout << text;
+    assert(text == "file.cc:10 value=0.00 count=0 hex=0x00ab %\n"
+                   "file.cc:11 value=1.50 count=1 hex=0x00ab %\n"
+                   "file.cc:12 value=3.00 count=2 hex=0x00ab %\n");
+
+    /* Binary records are smaller than the text they represent. */
+    std::size_t record_size = (output.size() - sizeof(BinaryLog::Header) -
+                               std::strlen(fmt)) /
+                              3;
+    std::cout << "record size: " << record_size << std::endl;
+
+    output.clear();
+    logger.log("%*d|%-*.*s|%lld|%Lf|%p|%c\n", 4, 7, 6, 2, "abcdef", -5ll,
+               2.5L, nullptr, 'z');
+    text = decode_all(output);
+    std::cout << text;
+
+    char expected[128];
+    snprintf(expected, sizeof(expected), "%*d|%-*.*s|%lld|%Lf|%p|%c\n", 4, 7,
+             6, 2, "abcdef", -5ll, 2.5L, nullptr, 'z');
+    assert(text == expected);
+
+    uint16_t truncated;
+    uint16_t dropped;
+    logger.poll_metrics(truncated, dropped);
+    assert(truncated == 0);
+    assert(dropped == 0);
+}
+
+static void test_truncation(void)
+{
+    output.clear();
+
+    BinaryLogger<decltype(&handler), 32, 1> logger(handler);
+
+    logger.log("%s\n", "a string that is too long to fit in a record");
+    logger.log("%d %d\n", 1, 2);
+
+    uint16_t truncated;
+    uint16_t dropped;
+    logger.poll_metrics(truncated, dropped);
+    assert(truncated == 1);
+    assert(dropped == 1);
+
+    std::string text = decode_all(output);
+    std::cout << text;
+    assert(text.ends_with("<truncated>\n"));
+}
+
+static void test_cobs(void)
+{
+    using Buffer = PcBuffer<1024, uint8_t>;
+
+    Buffer buffer;
+    BinaryLogger logger(cobs_log_handler(buffer));
+
+    logger.log("%d + %d = %d\n", 1, 2, 3);
+    logger.log("%d + %d = %d\n", 2, 2, 4);
+
+    BinaryLog::Decoder decoder;
+    std::stringstream stream;
+
+    Cobs::MessageDecoder<1024> frames(
+        [&decoder, &stream](const std::array<uint8_t, 1024> &data,
+                            std::size_t size) {
+            assert(decoder.decode(data.data(), size, stream) == size);
+        });
+    frames.dispatch(buffer);
+
+    std::cout << stream.str();
+    assert(stream.str() == "1 + 2 = 3\n2 + 2 = 4\n");
+}
+
+static void test_wire_format(void)
+{
+    output.clear();
+    num_records = 0;
+
+    const char *fmt = "%d %ld %f\n";
+    BinaryLogger<decltype(&handler), 64, 1> logger(handler);
+    logger.log(fmt, -2, 0x0102030405l, 1.0);
+    assert(num_records == 2);
+
+    /* The argument record's layout doesn't depend on the host. */
+    const std::vector<uint8_t> expected = {
+        BinaryLog::arguments, 0, 0, 20, 0,     /* header */
+        0xfe, 0xff, 0xff, 0xff,                /* int */
+        0x05, 0x04, 0x03, 0x02, 0x01, 0, 0, 0, /* long */
+        0, 0, 0, 0, 0, 0, 0xf0, 0x3f,          /* double */
+    };
+    std::size_t header = sizeof(BinaryLog::Header) + std::strlen(fmt);
+    assert(output.size() == header + expected.size());
+    assert(std::equal(expected.begin(), expected.end(),
+                      output.begin() + header));
+
+    assert(decode_all(output) == "-2 4328719365 1.000000\n");
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_wire_format();
+    test_truncation();
+    test_cobs();
+    return 0;
+}
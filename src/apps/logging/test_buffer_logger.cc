@@ -0,0 +1,71 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+/* internal */
+#include "logging/BufferLogger.h"
+
+/* toolchain */
+#include <cassert>
+#include <iostream>
+
+using namespace Coral;
+
+static std::string_view last_message;
+static bool last_truncated = false;
+
+static void handler(std::string_view message, bool truncated)
+{
+    std::cout << "'" << message << "'" << std::endl;
+    last_message = message;
+    last_truncated = truncated;
+}
+
+static void test_view_buffer_logger(void)
+{
+    ViewBufferLogger<decltype(&handler), 16> logger(handler);
+
+    logger.log("Hello, %d!", 1);
+    assert(last_message == "Hello, 1!");
+    assert(not last_truncated);
+
+    /* Message exactly fills the buffer (excluding terminator). */
+    logger.log("%s", "123456789012345");
+    assert(last_message.size() == 15);
+    assert(not last_truncated);
+
+    /* Message is one element too long. */
+    logger.log("%s", "1234567890123456");
+    assert(last_message == "123456789012345");
+    assert(last_truncated);
+
+    logger.log("%s", "");
+    assert(last_message.empty());
+    assert(not last_truncated);
+
+    uint16_t truncated;
+    uint16_t errors;
+    logger.poll_metrics(truncated, errors);
+    assert(truncated == 1);
+    assert(errors == 0);
+
+    logger.poll_metrics(truncated, errors);
+    assert(truncated == 0);
+
+    /* Lambda handlers are supported directly. */
+    std::size_t calls = 0;
+    ViewBufferLogger lambda_logger([&calls](std::string_view message,
+                                            bool truncated) {
+        (void)truncated;
+        assert(message == "lambda");
+        calls++;
+    });
+    lambda_logger.log("lambda");
+    assert(calls == 1);
+}
+
+int main(void)
+{
+    test_view_buffer_logger();
+    return 0;
+}
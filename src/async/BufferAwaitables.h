@@ -0,0 +1,206 @@
+/**
+ * \file
+ * \brief Awaitable operations for producer-consumer buffers.
+ */
+#pragma once
+
+/* toolchain */
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <span>
+
+/* internal */
+#include "../buffer/MessageBuffer.h"
+#include "../buffer/PcBuffer.h"
+#include "../buffer/cobs/Decoder.h"
+#include "Executor.h"
+
+namespace Coral
+{
+
+/*
+ * Notify the executor whenever a buffer gains data or space (uses both of
+ * the buffer's callbacks). Only needed for buffers changed by something
+ * other than the executor's coroutines and pollers.
+ */
+template <std::size_t depth, typename element_t>
+inline void notify_on(Executor &executor, PcBuffer<depth, element_t> &buffer)
+{
+    auto callback = [&executor](PcBuffer<depth, element_t> *) {
+        executor.notify();
+    };
+    buffer.set_data_available(callback);
+    buffer.set_space_available(callback);
+}
+
+/* Wait until a buffer has at least 'count' elements to read. */
+template <std::size_t depth, typename element_t>
+inline Until data(Executor &executor, PcBuffer<depth, element_t> &buffer,
+                  std::size_t count = 1)
+{
+    assert(count <= depth);
+    return Until(executor, [&buffer, count]() {
+        return buffer.state.data_available() >= count;
+    });
+}
+
+/* Wait until a buffer has space for at least 'count' elements. */
+template <std::size_t depth, typename element_t>
+inline Until space(Executor &executor, PcBuffer<depth, element_t> &buffer,
+                   std::size_t count = 1)
+{
+    assert(count <= depth);
+    return Until(executor, [&buffer, count]() {
+        return buffer.state.space_available() >= count;
+    });
+}
+
+/* Wait until a buffer is empty (e.g. all transmit data was written). */
+template <std::size_t depth, typename element_t>
+inline Until drained(Executor &executor, PcBuffer<depth, element_t> &buffer)
+{
+    return Until(executor, [&buffer]() { return buffer.empty(); });
+}
+
+/* Wait for 'count' elements, then read them. */
+template <std::size_t depth, typename element_t>
+class PopN : public Until
+{
+  public:
+    PopN(Executor &executor, PcBuffer<depth, element_t> &_buffer,
+         element_t *_elem_array, std::size_t _count)
+        : Until(data(executor, _buffer, _count)), buffer(_buffer),
+          elem_array(_elem_array), count(_count)
+    {
+    }
+
+    Result await_resume()
+    {
+        return buffer.pop_n(elem_array, count);
+    }
+
+  protected:
+    PcBuffer<depth, element_t> &buffer;
+    element_t *elem_array;
+    std::size_t count;
+};
+
+template <std::size_t depth, typename element_t>
+inline PopN<depth, element_t> pop_n(Executor &executor,
+                                    PcBuffer<depth, element_t> &buffer,
+                                    element_t *elem_array, std::size_t count)
+{
+    return PopN<depth, element_t>(executor, buffer, elem_array, count);
+}
+
+/* Wait for space for 'count' elements, then write them. */
+template <std::size_t depth, typename element_t>
+class PushN : public Until
+{
+  public:
+    PushN(Executor &executor, PcBuffer<depth, element_t> &_buffer,
+          const element_t *_elem_array, std::size_t _count)
+        : Until(space(executor, _buffer, _count)), buffer(_buffer),
+          elem_array(_elem_array), count(_count)
+    {
+    }
+
+    Result await_resume()
+    {
+        return buffer.push_n(elem_array, count);
+    }
+
+  protected:
+    PcBuffer<depth, element_t> &buffer;
+    const element_t *elem_array;
+    std::size_t count;
+};
+
+template <std::size_t depth, typename element_t>
+inline PushN<depth, element_t> push_n(Executor &executor,
+                                      PcBuffer<depth, element_t> &buffer,
+                                      const element_t *elem_array,
+                                      std::size_t count)
+{
+    return PushN<depth, element_t>(executor, buffer, elem_array, count);
+}
+
+static constexpr std::size_t default_async_frames = 4;
+
+/**
+ * A COBS decoder that frames can be awaited from. Decoded frames are queued
+ * (up to 'max_frames', more are dropped) until they're awaited.
+ */
+template <std::size_t mtu, std::size_t max_frames = default_async_frames>
+class AsyncDecoder
+{
+  public:
+    using Frame = std::span<const uint8_t>;
+
+    AsyncDecoder(Executor &_executor)
+        : executor(_executor), frames(), current(), dropped(0),
+          decoder([this](const std::array<uint8_t, mtu> &message,
+                         std::size_t size) {
+              if (not ToBool(frames.put_message(message.data(), size)))
+              {
+                  dropped++;
+              }
+          })
+    {
+    }
+
+    /*
+     * Wait for the next frame (decoding data from 'reader' as it arrives).
+     * The frame is valid until the next one is awaited.
+     */
+    template <class T, typename element_t>
+    auto next_frame(PcBufferReader<T, element_t> &reader)
+    {
+        struct Awaiter : public Until
+        {
+            AsyncDecoder &parent;
+
+            Frame await_resume()
+            {
+                return parent.take();
+            }
+        };
+
+        return Awaiter{{executor, [this, &reader]() {
+                            decoder.dispatch(reader);
+                            return not frames.empty();
+                        }},
+                       *this};
+    }
+
+    void poll_metrics(uint32_t &_dropped, bool reset = true)
+    {
+        _dropped = dropped;
+
+        if (reset)
+        {
+            dropped = 0;
+        }
+    }
+
+  protected:
+    Executor &executor;
+    MessageBuffer<mtu * max_frames, max_frames, uint8_t> frames;
+    std::array<uint8_t, mtu> current;
+    uint32_t dropped;
+
+    Cobs::MessageDecoder<mtu> decoder;
+
+    Frame take(void)
+    {
+        std::size_t size = current.size();
+        bool result = ToBool(frames.get_message(current.data(), size));
+        assert(result);
+        (void)result;
+
+        return Frame(current.data(), size);
+    }
+};
+
+} // namespace Coral
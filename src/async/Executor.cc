@@ -0,0 +1,220 @@
+/* linux */
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+/* toolchain */
+#include <cerrno>
+
+/* internal */
+#include "../logging/macros.h"
+#include "Executor.h"
+
+namespace Coral
+{
+
+Executor::Executor()
+    : tasks(), starting(), waiters(), checking(), fresh(0), pollers(),
+      fd_pollers(), pollfds(),
+      event_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), notified(false),
+      sleeping(false), resumes(0), polls(0)
+{
+    LogErrnoIf(event_fd == -1);
+}
+
+Executor::~Executor()
+{
+    /* Coroutines that are still waiting are owned by tasks. */
+    for (auto handle : tasks)
+    {
+        handle.destroy();
+    }
+
+    if (event_fd != -1)
+    {
+        LogErrnoIfNot(close(event_fd) == 0);
+    }
+}
+
+void Executor::spawn(Task &&task)
+{
+    auto handle = task.release();
+    if (handle)
+    {
+        tasks.push_back(handle);
+        starting.push_back(handle);
+    }
+}
+
+void Executor::add_poller(Poller poller)
+{
+    pollers.push_back(std::move(poller));
+}
+
+void Executor::add_poller(int fd, short events, Poller poller)
+{
+    fd_pollers.push_back({fd, events, std::move(poller)});
+}
+
+void Executor::wait(std::coroutine_handle<> handle, Predicate predicate)
+{
+    waiters.push_back({handle, std::move(predicate)});
+    fresh++;
+}
+
+void Executor::notify()
+{
+    /* Only a sleeping executor has to be woken. */
+    if (not notified.exchange(true) and sleeping and event_fd != -1)
+    {
+        uint64_t value = 1;
+        LogErrnoIf(write(event_fd, &value, sizeof(value)) < 0 and
+                   errno != EAGAIN);
+    }
+}
+
+bool Executor::busy() const
+{
+    return not pollers.empty() or not starting.empty() or fresh or notified;
+}
+
+std::size_t Executor::poll_fds(int timeout)
+{
+    pollfds.clear();
+    pollfds.push_back({event_fd, POLLIN, 0});
+    for (auto &entry : fd_pollers)
+    {
+        pollfds.push_back({entry.fd, entry.events, 0});
+    }
+
+    /* Announce sleeping before the final check (see 'notify'). */
+    sleeping = true;
+    if (busy())
+    {
+        timeout = 0;
+    }
+    int result = ::poll(pollfds.data(), pollfds.size(), timeout);
+    sleeping = false;
+
+    if (result <= 0)
+    {
+        LogErrnoIf(result < 0 and errno != EINTR);
+        return 0;
+    }
+
+    if (pollfds[0].revents & POLLIN)
+    {
+        uint64_t value;
+        LogErrnoIf(read(event_fd, &value, sizeof(value)) < 0 and
+                   errno != EAGAIN);
+    }
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < fd_pollers.size(); i++)
+    {
+        if (pollfds[i + 1].revents)
+        {
+            fd_pollers[i].poller();
+            count++;
+        }
+    }
+
+    return count;
+}
+
+std::size_t Executor::poll(int timeout)
+{
+    std::size_t count = 0;
+    polls++;
+
+    if (busy())
+    {
+        timeout = 0;
+    }
+
+    bool changed = false;
+    if (timeout != 0 or not fd_pollers.empty())
+    {
+        changed = poll_fds(timeout) > 0;
+    }
+
+    for (auto &poller : pollers)
+    {
+        poller();
+        changed = true;
+    }
+
+    /* Predicates that were already false only change if something ran. */
+    changed = notified.exchange(false) or changed;
+
+    /*
+     * Resuming coroutines can add (fresh) waiters, which may land between
+     * those carried over.
+     */
+    fresh = 0;
+    std::swap(waiters, checking);
+    for (auto &waiter : checking)
+    {
+        bool check = changed or waiter.fresh;
+        waiter.fresh = false;
+
+        if (check and waiter.predicate())
+        {
+            waiter.handle.resume();
+            count++;
+        }
+        else
+        {
+            waiters.push_back(std::move(waiter));
+        }
+    }
+    checking.clear();
+
+    /* Tasks can spawn other tasks (started in order). */
+    for (std::size_t i = 0; i < starting.size(); i++)
+    {
+        starting[i].resume();
+        count++;
+    }
+    starting.clear();
+
+    /* Clean up completed tasks. */
+    std::erase_if(tasks, [](Task::Handle handle) {
+        bool done = handle.done();
+        if (done)
+        {
+            handle.destroy();
+        }
+        return done;
+    });
+
+    /* Whatever ran may have changed other coroutines' predicates. */
+    if (count)
+    {
+        notified = true;
+    }
+
+    resumes += count;
+    return count;
+}
+
+void Executor::run()
+{
+    while (pending())
+    {
+        poll(-1);
+    }
+}
+
+void Executor::poll_metrics(uint32_t &_resumes, uint32_t &_polls, bool reset)
+{
+    _resumes = resumes;
+    _polls = polls;
+
+    if (reset)
+    {
+        resumes = 0;
+        polls = 0;
+    }
+}
+
+} // namespace Coral
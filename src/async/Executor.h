@@ -0,0 +1,202 @@
+/**
+ * \file
+ * \brief A single-threaded coroutine executor.
+ */
+#pragma once
+
+/* linux */
+#include <poll.h>
+
+/* toolchain */
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* internal */
+#include "Task.h"
+
+namespace Coral
+{
+
+/**
+ * Runs tasks on the calling thread. Suspended coroutines wait for a
+ * predicate (e.g. "the buffer has data"). Predicates are only checked again
+ * after something may have changed the result: a coroutine ran, a poller
+ * ran (e.g. a link's 'dispatch' moved data) or 'notify' was called (e.g.
+ * from a buffer callback or another thread).
+ *
+ * When nothing can make progress, 'run' sleeps until it's notified or a
+ * poller's file descriptor is ready (pollers without one run every poll, so
+ * the executor never sleeps while there are any).
+ */
+class Executor
+{
+  public:
+    using Predicate = std::function<bool()>;
+    using Poller = std::function<void()>;
+
+    Executor();
+    ~Executor();
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /* Take ownership of a task (it starts on the next poll). */
+    void spawn(Task &&task);
+
+    /* Call 'poller' at the start of every poll. */
+    void add_poller(Poller poller);
+
+    /*
+     * Call 'poller' when 'fd' is ready for 'events' (see poll(2)). The
+     * descriptor must stay open while the executor runs.
+     */
+    void add_poller(int fd, short events, Poller poller);
+
+    /* Resume 'handle' (on a future poll) once 'predicate' holds. */
+    void wait(std::coroutine_handle<> handle, Predicate predicate);
+
+    /*
+     * Check waiting coroutines' predicates on the next poll (waking 'run'
+     * if it's sleeping). Can be called from any thread.
+     */
+    void notify();
+
+    /*
+     * Run pollers, start spawned tasks and resume waiting coroutines whose
+     * predicates hold. Waits up to 'timeout' milliseconds (-1 for no limit)
+     * for a notification or a ready file descriptor first, unless there's
+     * already something to do. Returns the number of coroutines resumed.
+     */
+    std::size_t poll(int timeout = 0);
+
+    /* Poll (sleeping when idle) until every task completes. */
+    void run();
+
+    /* The number of spawned tasks that haven't completed. */
+    inline std::size_t pending() const
+    {
+        return tasks.size();
+    }
+
+    void poll_metrics(uint32_t &_resumes, uint32_t &_polls,
+                      bool reset = true);
+
+  protected:
+    std::vector<Task::Handle> tasks;
+    std::vector<Task::Handle> starting;
+
+    struct Waiter
+    {
+        std::coroutine_handle<> handle;
+        Predicate predicate;
+
+        /* Not checked yet (so its predicate may already be true). */
+        bool fresh = true;
+    };
+    std::vector<Waiter> waiters;
+    std::vector<Waiter> checking;
+
+    /* The number of fresh waiters (always checked once). */
+    std::size_t fresh;
+
+    std::vector<Poller> pollers;
+
+    struct FdPoller
+    {
+        int fd;
+        short events;
+        Poller poller;
+    };
+    std::vector<FdPoller> fd_pollers;
+    std::vector<pollfd> pollfds;
+
+    /* Wakes a sleeping executor (see 'notify'). */
+    int event_fd;
+    std::atomic<bool> notified;
+    std::atomic<bool> sleeping;
+
+    /* Metrics. */
+    uint32_t resumes;
+    uint32_t polls;
+
+    /* Whether anything can make progress without a notification. */
+    bool busy() const;
+
+    /*
+     * Wait for file descriptors (or a notification), then run the pollers
+     * of those ready. Returns the number of pollers run.
+     */
+    std::size_t poll_fds(int timeout);
+};
+
+/*
+ * Suspends the awaiting coroutine until a predicate holds (doesn't suspend
+ * if it already does).
+ */
+class Until
+{
+  public:
+    Until(Executor &_executor, Executor::Predicate _predicate)
+        : executor(_executor), predicate(std::move(_predicate))
+    {
+    }
+
+    bool await_ready()
+    {
+        return predicate();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        executor.wait(handle, std::move(predicate));
+    }
+
+    void await_resume()
+    {
+    }
+
+  protected:
+    Executor &executor;
+    Executor::Predicate predicate;
+};
+
+inline Until until(Executor &executor, Executor::Predicate predicate)
+{
+    return Until(executor, std::move(predicate));
+}
+
+/* Suspends the awaiting coroutine until the next poll. */
+class Yield
+{
+  public:
+    Yield(Executor &_executor) : executor(_executor)
+    {
+    }
+
+    bool await_ready()
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        executor.wait(handle, []() { return true; });
+    }
+
+    void await_resume()
+    {
+    }
+
+  protected:
+    Executor &executor;
+};
+
+inline Yield yield(Executor &executor)
+{
+    return Yield(executor);
+}
+
+} // namespace Coral
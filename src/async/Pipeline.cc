@@ -0,0 +1,68 @@
+/* linux */
+#include <pthread.h>
+#include <sched.h>
+
+/* internal */
+#include "Pipeline.h"
+
+namespace Coral
+{
+
+StageThread::StageThread(Step _step, int cpu)
+    : step(std::move(_step)), is_pinned(false), steps(0), idle(0),
+      thread([this](std::stop_token token) { run(token); })
+{
+    if (cpu >= 0 and cpu < CPU_SETSIZE)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        is_pinned = pthread_setaffinity_np(thread.native_handle(),
+                                           sizeof(set), &set) == 0;
+    }
+}
+
+void StageThread::stop()
+{
+    if (thread.joinable())
+    {
+        thread.request_stop();
+        thread.join();
+    }
+}
+
+void StageThread::poll_metrics(uint32_t &_steps, uint32_t &_idle, bool reset)
+{
+    _steps = (reset) ? steps.exchange(0) : steps.load();
+    _idle = (reset) ? idle.exchange(0) : idle.load();
+}
+
+void StageThread::run(std::stop_token token)
+{
+    uint32_t idle_steps = 0;
+
+    while (not token.stop_requested())
+    {
+        steps++;
+
+        if (step(token))
+        {
+            idle_steps = 0;
+            continue;
+        }
+
+        idle++;
+
+        if (++idle_steps < idle_spins)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(idle_sleep);
+        }
+    }
+}
+
+} // namespace Coral
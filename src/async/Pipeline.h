@@ -0,0 +1,363 @@
+/**
+ * \file
+ * \brief Frame-processing stages (decode, handle, encode) on separate threads.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/* internal */
+#include "../buffer/cobs/Decoder.h"
+#include "../buffer/cobs/Encoder.h"
+#include "SpscRing.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_stage_depth = 64;
+
+/* A decoded (or to-be-encoded) frame passed between stages. */
+template <std::size_t mtu> struct Frame
+{
+    std::array<uint8_t, mtu> data;
+    std::size_t size = 0;
+
+    inline std::span<const uint8_t> view() const
+    {
+        return std::span<const uint8_t>(data.data(), size);
+    }
+};
+
+/**
+ * Repeatedly runs one stage's step on a dedicated thread, optionally pinned
+ * to a CPU. A step returns whether it made progress: idle steps yield, and
+ * sustained idleness sleeps briefly so that idle stages don't hold a core.
+ *
+ * Steps get the thread's stop token so that they can stop waiting (e.g. on
+ * a full output ring) when the stage is stopped.
+ */
+class StageThread
+{
+  public:
+    using Step = std::function<bool(std::stop_token)>;
+
+    static constexpr int any_cpu = -1;
+
+    StageThread(Step _step, int cpu = any_cpu);
+
+    StageThread(const StageThread &) = delete;
+    StageThread &operator=(const StageThread &) = delete;
+
+    /* Stop (and join) the thread; the destructor also does this. */
+    void stop();
+
+    /* Whether the thread was pinned to the requested CPU. */
+    inline bool pinned() const
+    {
+        return is_pinned;
+    }
+
+    void poll_metrics(uint32_t &_steps, uint32_t &_idle, bool reset = true);
+
+  protected:
+    /* Idle steps that only yield (before sleeping between steps). */
+    static constexpr uint32_t idle_spins = 64;
+    static constexpr auto idle_sleep = std::chrono::microseconds(50);
+
+    Step step;
+    bool is_pinned;
+
+    /* Metrics. */
+    std::atomic<uint32_t> steps;
+    std::atomic<uint32_t> idle;
+
+    /* Declared last: the thread starts once everything else is ready. */
+    std::jthread thread;
+
+    void run(std::stop_token token);
+};
+
+/**
+ * Owns the threads running a chain of stages. Stages are stopped in the
+ * order they were added (i.e. upstream first).
+ */
+class Pipeline
+{
+  public:
+    Pipeline() : threads()
+    {
+    }
+
+    ~Pipeline()
+    {
+        stop();
+    }
+
+    /* Start running a stage (which must outlive the pipeline). */
+    template <class Stage>
+    StageThread &add(Stage &stage, int cpu = StageThread::any_cpu)
+    {
+        threads.push_back(std::make_unique<StageThread>(
+            [&stage](std::stop_token token) { return stage(token); }, cpu));
+        return *threads.back();
+    }
+
+    inline StageThread &operator[](std::size_t index)
+    {
+        return *threads[index];
+    }
+
+    inline std::size_t size() const
+    {
+        return threads.size();
+    }
+
+    void stop()
+    {
+        for (auto &thread : threads)
+        {
+            thread->stop();
+        }
+    }
+
+  protected:
+    std::vector<std::unique_ptr<StageThread>> threads;
+};
+
+/* Yield until 'ready' (false if the stage was stopped first). */
+template <typename Predicate>
+bool stage_wait(std::stop_token &token, Predicate ready)
+{
+    while (not ready())
+    {
+        if (token.stop_requested())
+        {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/**
+ * Decodes COBS frames from an input buffer into a ring. When the ring is
+ * full, decoding waits (and stops consuming the input), so back-pressure
+ * reaches whatever fills the input.
+ *
+ * An optional service function runs before every step (e.g. reading a
+ * file descriptor into the input buffer).
+ */
+template <std::size_t mtu, std::size_t depth, class Reader,
+          typename element_t>
+class DecodeStage
+{
+  public:
+    using Ring = SpscRing<Frame<mtu>, depth>;
+    using Service = std::function<void()>;
+
+    DecodeStage(PcBufferReader<Reader, element_t> &_input, Ring &_output,
+                Service _service = nullptr)
+        : input(_input), output(_output), service(_service), token(nullptr),
+          decoded(false), dropped(0),
+          decoder([this](const std::array<uint8_t, mtu> &message,
+                         std::size_t size) { forward(message, size); })
+    {
+    }
+
+    bool operator()(std::stop_token &_token)
+    {
+        if (service)
+        {
+            service();
+        }
+
+        token = &_token;
+        decoded = false;
+        decoder.dispatch(input);
+        token = nullptr;
+
+        return decoded;
+    }
+
+    /* Frames dropped because the stage stopped while waiting for space. */
+    void poll_metrics(uint32_t &_dropped, bool reset = true)
+    {
+        _dropped = dropped;
+
+        if (reset)
+        {
+            dropped = 0;
+        }
+    }
+
+  protected:
+    PcBufferReader<Reader, element_t> &input;
+    Ring &output;
+    Service service;
+
+    std::stop_token *token;
+    bool decoded;
+    std::atomic<uint32_t> dropped;
+
+    Cobs::MessageDecoder<mtu> decoder;
+
+    void forward(const std::array<uint8_t, mtu> &message, std::size_t size)
+    {
+        Frame<mtu> *frame = nullptr;
+
+        if (not stage_wait(*token, [this, &frame]() {
+                frame = output.claim();
+                return frame != nullptr;
+            }))
+        {
+            dropped++;
+            return;
+        }
+
+        std::copy_n(message.begin(), size, frame->data.begin());
+        frame->size = size;
+        output.publish();
+        decoded = true;
+    }
+};
+
+/**
+ * Applies a handler to frames from one ring, putting its results in
+ * another. Input is only taken when the output has space (so a slow
+ * downstream stage stalls this one, then the one before it). The handler
+ * fills the output in place and returns false to drop a frame.
+ */
+template <class In, class Out, std::size_t in_depth = default_stage_depth,
+          std::size_t out_depth = default_stage_depth>
+class HandlerStage
+{
+  public:
+    using InRing = SpscRing<In, in_depth>;
+    using OutRing = SpscRing<Out, out_depth>;
+    using Handler = std::function<bool(const In &, Out &)>;
+
+    HandlerStage(InRing &_input, OutRing &_output, Handler _handler)
+        : input(_input), output(_output), handler(_handler)
+    {
+    }
+
+    bool operator()(std::stop_token &token)
+    {
+        (void)token;
+
+        bool progress = false;
+
+        while (true)
+        {
+            Out *result = output.claim();
+            if (not result)
+            {
+                break;
+            }
+
+            In *frame = input.peek();
+            if (not frame)
+            {
+                break;
+            }
+
+            if (handler(*frame, *result))
+            {
+                output.publish();
+            }
+            input.pop();
+            progress = true;
+        }
+
+        return progress;
+    }
+
+  protected:
+    InRing &input;
+    OutRing &output;
+    Handler handler;
+};
+
+/**
+ * COBS-encodes frames from a ring into an output buffer. A frame stays in
+ * the ring until it's completely encoded, so a full output stalls upstream
+ * stages.
+ *
+ * An optional service function runs after every step (e.g. writing the
+ * output buffer to a file descriptor).
+ */
+template <std::size_t mtu, std::size_t depth, class Writer,
+          typename element_t>
+class EncodeStage
+{
+  public:
+    using Ring = SpscRing<Frame<mtu>, depth>;
+    using Service = std::function<void()>;
+
+    EncodeStage(Ring &_input, PcBufferWriter<Writer, element_t> &_output,
+                Service _service = nullptr)
+        : input(_input), output(_output), service(_service), encoder(),
+          encoding(false)
+    {
+    }
+
+    bool operator()(std::stop_token &token)
+    {
+        (void)token;
+
+        bool progress = false;
+
+        while (Frame<mtu> *frame = input.peek())
+        {
+            /* There's nothing to encode for an empty frame. */
+            if (not frame->size)
+            {
+                input.pop();
+                continue;
+            }
+
+            if (not encoding)
+            {
+                encoder.stage(frame->data.data(), frame->size);
+                encoding = true;
+            }
+
+            if (not encoder.encode(output))
+            {
+                break;
+            }
+
+            encoding = false;
+            input.pop();
+            progress = true;
+        }
+
+        if (service)
+        {
+            service();
+        }
+
+        return progress;
+    }
+
+  protected:
+    Ring &input;
+    PcBufferWriter<Writer, element_t> &output;
+    Service service;
+
+    Cobs::MessageEncoder encoder;
+    bool encoding;
+};
+
+} // namespace Coral
@@ -0,0 +1,158 @@
+/**
+ * \file
+ * \brief A lock-free, single-producer single-consumer ring.
+ */
+#pragma once
+
+/* toolchain */
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+namespace Coral
+{
+
+/* Keeps each side's indices from sharing a cache line (false sharing). */
+static constexpr std::size_t cache_line_size = 64;
+
+/**
+ * Passes elements from exactly one producer thread to exactly one consumer
+ * thread. Each side keeps a cached copy of the other side's index so that
+ * the shared indices are only re-read when the ring appears full (or empty).
+ *
+ * \tparam T     The kind of element passed.
+ * \tparam depth The number of elements the ring holds (a power of two).
+ */
+template <typename T, std::size_t depth> class SpscRing
+{
+    static_assert(std::has_single_bit(depth));
+
+  public:
+    SpscRing()
+        : elements(), head(0), cached_tail(0), full_count(0), tail(0),
+          cached_head(0)
+    {
+    }
+
+    /* Producer: add an element (fails if the ring is full). */
+    bool try_push(T &&elem)
+    {
+        T *slot = claim();
+        if (slot)
+        {
+            *slot = std::move(elem);
+            publish();
+        }
+        return slot != nullptr;
+    }
+
+    inline bool try_push(const T &elem)
+    {
+        T copy = elem;
+        return try_push(std::move(copy));
+    }
+
+    /*
+     * Producer: get the next slot to fill in place (nullptr if the ring is
+     * full). The element isn't visible to the consumer until 'publish'.
+     */
+    T *claim(void)
+    {
+        std::size_t index = head.load(std::memory_order_relaxed);
+
+        if (index - cached_tail >= depth)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (index - cached_tail >= depth)
+            {
+                full_count++;
+                return nullptr;
+            }
+        }
+
+        return &elements[index & mask];
+    }
+
+    /* Producer: add the element filled through 'claim'. */
+    inline void publish(void)
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    /* Producer: check for space without adding anything. */
+    bool full(void)
+    {
+        std::size_t index = head.load(std::memory_order_relaxed);
+        if (index - cached_tail >= depth)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+        }
+        return index - cached_tail >= depth;
+    }
+
+    /* Consumer: remove an element (fails if the ring is empty). */
+    bool try_pop(T &elem)
+    {
+        T *front = peek();
+        if (front)
+        {
+            elem = std::move(*front);
+            pop();
+        }
+        return front != nullptr;
+    }
+
+    /* Consumer: get the oldest element in place (nullptr if empty). */
+    T *peek(void)
+    {
+        std::size_t index = tail.load(std::memory_order_relaxed);
+
+        if (index == cached_head)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (index == cached_head)
+            {
+                return nullptr;
+            }
+        }
+
+        return &elements[index & mask];
+    }
+
+    /* Consumer: release the element returned by 'peek'. */
+    inline void pop(void)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    /* Producer: the number of pushes that found the ring full. */
+    void poll_metrics(uint32_t &_full_count, bool reset = true)
+    {
+        _full_count = full_count;
+
+        if (reset)
+        {
+            full_count = 0;
+        }
+    }
+
+  protected:
+    static constexpr std::size_t mask = depth - 1;
+
+    std::array<T, depth> elements;
+
+    /* Producer state (and its view of the consumer). */
+    alignas(cache_line_size) std::atomic<std::size_t> head;
+    std::size_t cached_tail;
+    uint32_t full_count;
+
+    /* Consumer state (and its view of the producer). */
+    alignas(cache_line_size) std::atomic<std::size_t> tail;
+    std::size_t cached_head;
+};
+
+} // namespace Coral
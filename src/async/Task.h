@@ -0,0 +1,141 @@
+/**
+ * \file
+ * \brief A coroutine task type.
+ */
+#pragma once
+
+/* toolchain */
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace Coral
+{
+
+/**
+ * A lazily started coroutine (with no result). Tasks are either spawned on
+ * an \ref Executor (which owns them) or awaited by another task, in which
+ * case the awaiting task resumes once the awaited one completes.
+ */
+class Task
+{
+  public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type
+    {
+        /* Resumed when this task completes (if it was awaited). */
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object()
+        {
+            return Task(Handle::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept
+            {
+                auto continuation = handle.promise().continuation;
+                return (continuation) ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    Task(Handle _handle = nullptr) : handle(_handle)
+    {
+    }
+
+    Task(Task &&other) : handle(std::exchange(other.handle, nullptr))
+    {
+    }
+
+    Task &operator=(Task &&other)
+    {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    inline bool done() const
+    {
+        return not handle or handle.done();
+    }
+
+    /* Give up ownership of the coroutine. */
+    inline Handle release()
+    {
+        return std::exchange(handle, nullptr);
+    }
+
+    /* Awaiting a task runs it (the awaiter resumes once it completes). */
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            Handle child;
+
+            bool await_ready() noexcept
+            {
+                return not child or child.done();
+            }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<> awaiting) noexcept
+            {
+                child.promise().continuation = awaiting;
+                return child;
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        return Awaiter{handle};
+    }
+
+  protected:
+    Handle handle;
+};
+
+} // namespace Coral
@@ -0,0 +1,215 @@
+/* toolchain */
+#include <algorithm>
+
+/* internal */
+#include "WorkStealingPool.h"
+
+namespace Coral
+{
+
+/* The pool (and queue) of the worker running on this thread. */
+static thread_local WorkStealingPool *current_pool = nullptr;
+static thread_local std::size_t current_index = 0;
+
+WorkStealingPool::WorkStealingPool(std::size_t num_workers)
+    : queues(), workers(), outstanding(0), next_queue(0), stopping(false),
+      sleep_mutex(), work_available(), idle(), queued(0), executed(0),
+      stolen(0)
+{
+    if (num_workers == 0)
+    {
+        num_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 0; i < num_workers; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    for (std::size_t i = 0; i < num_workers; i++)
+    {
+        workers.emplace_back([this, i]() { run(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    /* Workers finish every queued job before exiting. */
+    {
+        std::lock_guard lock(sleep_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Job job, bool yield)
+{
+    outstanding++;
+
+    std::size_t index = (current_pool == this)
+                            ? current_index
+                            : next_queue++ % queues.size();
+
+    /* Count the job first so that 'queued' never underflows. */
+    {
+        std::lock_guard lock(sleep_mutex);
+        queued++;
+    }
+
+    {
+        std::lock_guard lock(queues[index]->mutex);
+        if (yield)
+        {
+            queues[index]->jobs.push_front(std::move(job));
+        }
+        else
+        {
+            queues[index]->jobs.push_back(std::move(job));
+        }
+    }
+    work_available.notify_one();
+}
+
+void WorkStealingPool::wait_idle()
+{
+    std::unique_lock lock(sleep_mutex);
+    idle.wait(lock, [this]() { return outstanding == 0; });
+}
+
+void WorkStealingPool::poll_metrics(uint32_t &_executed, uint32_t &_stolen,
+                                    bool reset)
+{
+    _executed = (reset) ? executed.exchange(0) : executed.load();
+    _stolen = (reset) ? stolen.exchange(0) : stolen.load();
+}
+
+bool WorkStealingPool::take(std::size_t index, Job &job)
+{
+    /* Run the newest local job first. */
+    {
+        auto &queue = *queues[index];
+        std::lock_guard lock(queue.mutex);
+        if (not queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    /* Steal the oldest job from another worker. */
+    for (std::size_t i = 1; i < queues.size(); i++)
+    {
+        auto &queue = *queues[(index + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (not queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            queued--;
+            stolen++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::finish()
+{
+    executed++;
+
+    if (--outstanding == 0)
+    {
+        std::lock_guard lock(sleep_mutex);
+        idle.notify_all();
+    }
+}
+
+void WorkStealingPool::run(std::size_t index)
+{
+    current_pool = this;
+    current_index = index;
+
+    Job job;
+
+    while (true)
+    {
+        if (take(index, job))
+        {
+            job();
+            job = nullptr;
+            finish();
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex);
+        work_available.wait(lock,
+                            [this]() { return queued > 0 or stopping; });
+
+        if (stopping and queued == 0)
+        {
+            break;
+        }
+    }
+}
+
+void Strand::post(WorkStealingPool::Job job)
+{
+    bool schedule;
+
+    {
+        std::lock_guard lock(mutex);
+        jobs.push_back(std::move(job));
+        schedule = not scheduled;
+        scheduled = true;
+    }
+
+    if (schedule)
+    {
+        pool.submit([this]() { drain(); });
+    }
+}
+
+void Strand::drain()
+{
+    WorkStealingPool::Job job;
+
+    for (std::size_t i = 0; i < batch; i++)
+    {
+        {
+            std::lock_guard lock(mutex);
+            if (jobs.empty())
+            {
+                scheduled = false;
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job();
+    }
+
+    /*
+     * Let other strands run (this continues later, still in order, behind
+     * anything already queued).
+     */
+    {
+        std::lock_guard lock(mutex);
+        if (jobs.empty())
+        {
+            scheduled = false;
+            return;
+        }
+    }
+    pool.submit([this]() { drain(); }, true);
+}
+
+} // namespace Coral
@@ -0,0 +1,115 @@
+/**
+ * \file
+ * \brief A work-stealing thread pool (and ordered strands of work).
+ */
+#pragma once
+
+/* toolchain */
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Coral
+{
+
+/**
+ * Runs jobs on a fixed set of worker threads. Every worker has its own
+ * queue: jobs submitted from a worker go to its own queue (run newest
+ * first, while data is warm) and idle workers steal the oldest jobs from
+ * other queues. Jobs submitted from other threads are spread across the
+ * queues.
+ *
+ * A job that yields (e.g. a long-running one continuing after letting
+ * others run) goes to the oldest end of the queue instead, so it runs after
+ * everything already queued rather than before it.
+ */
+class WorkStealingPool
+{
+  public:
+    using Job = std::function<void()>;
+
+    WorkStealingPool(std::size_t num_workers = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Job job, bool yield = false);
+
+    /* Block until every submitted job has run. */
+    void wait_idle();
+
+    inline std::size_t size() const
+    {
+        return queues.size();
+    }
+
+    void poll_metrics(uint32_t &_executed, uint32_t &_stolen,
+                      bool reset = true);
+
+  protected:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    /* Submitted jobs that haven't completed. */
+    std::atomic<std::size_t> outstanding;
+    std::atomic<std::size_t> next_queue;
+    std::atomic<bool> stopping;
+
+    /* Idle workers (and 'wait_idle' callers) sleep here. */
+    std::mutex sleep_mutex;
+    std::condition_variable work_available;
+    std::condition_variable idle;
+    std::atomic<std::size_t> queued;
+
+    /* Metrics. */
+    std::atomic<uint32_t> executed;
+    std::atomic<uint32_t> stolen;
+
+    void run(std::size_t index);
+    bool take(std::size_t index, Job &job);
+    void finish();
+};
+
+/**
+ * Runs jobs in the order they're posted, one at a time, on a pool (e.g. all
+ * of the servicing for one link). Different strands run concurrently.
+ */
+class Strand
+{
+  public:
+    static constexpr std::size_t default_batch = 16;
+
+    Strand(WorkStealingPool &_pool, std::size_t _batch = default_batch)
+        : pool(_pool), batch(_batch), mutex(), jobs(), scheduled(false)
+    {
+    }
+
+    void post(WorkStealingPool::Job job);
+
+  protected:
+    WorkStealingPool &pool;
+
+    /* Jobs run per pool job (before yielding to other strands). */
+    std::size_t batch;
+
+    std::mutex mutex;
+    std::deque<WorkStealingPool::Job> jobs;
+    bool scheduled;
+
+    void drain();
+};
+
+} // namespace Coral
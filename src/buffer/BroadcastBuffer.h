@@ -0,0 +1,366 @@
+/**
+ * \file
+ * \brief A single-producer, multiple-reader (broadcast) buffer.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <span>
+
+/* internal */
+#include "../result.h"
+#include "CircularBuffer.h"
+#include "PcBufferReader.h"
+#include "PcBufferWriter.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_broadcast_readers = 4;
+
+/**
+ * A circular buffer where every attached reader has its own cursor, so that
+ * each written element is stored once regardless of how many consumers see
+ * it.
+ *
+ * By default the writer is limited by the slowest reader (no reader misses
+ * data). When lapping is enabled, writes always succeed and readers that
+ * fall more than a buffer behind skip ahead (counting what they missed).
+ *
+ * \tparam depth       The number of elements the buffer holds.
+ * \tparam element_t   The kind of element stored.
+ * \tparam max_readers The number of readers that can be attached at once.
+ */
+template <std::size_t depth, typename element_t = std::byte,
+          std::size_t max_readers = default_broadcast_readers>
+class BroadcastBuffer
+    : public PcBufferWriter<BroadcastBuffer<depth, element_t, max_readers>,
+                            element_t>
+{
+  public:
+    using ServiceCallback = std::function<void(BroadcastBuffer *)>;
+
+    /*
+     * A reading end. Readers attach on construction (and detach on
+     * destruction) and start with the next element written. A reader that
+     * couldn't attach (all 'max_readers' slots are in use) is invalid and
+     * never has data.
+     */
+    class Reader : public PcBufferReader<Reader, element_t>
+    {
+      public:
+        Reader(BroadcastBuffer &_parent)
+            : parent(_parent), cursor(parent.buffer.write_cursor()),
+              lapped(0), attached(parent.attach(this))
+        {
+        }
+
+        ~Reader()
+        {
+            if (attached)
+            {
+                parent.detach(this);
+            }
+        }
+
+        inline bool valid(void) const
+        {
+            return attached;
+        }
+
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        inline std::size_t data_available(void)
+        {
+            if (not attached)
+            {
+                return 0;
+            }
+
+            catch_up();
+            return parent.buffer.write_cursor() - cursor;
+        }
+
+        inline bool empty(void)
+        {
+            return data_available() == 0;
+        }
+
+        /*
+         * Get the contiguous region of unread elements (elements can be
+         * read in place and then consumed with a null-array pop_n).
+         */
+        inline std::span<element_t> read_region(void)
+        {
+            return parent.buffer.region_at(cursor, data_available());
+        }
+
+        inline element_t peek(void)
+        {
+            if (not attached)
+            {
+                return element_t();
+            }
+
+            /* Don't return an element that was overwritten. */
+            catch_up();
+            return *parent.buffer.region_at(cursor, 1).data();
+        }
+
+        Result pop_impl(element_t &elem)
+        {
+            return pop_n_impl(&elem, 1);
+        }
+
+        Result pop_n_impl(element_t *elem_array, std::size_t count)
+        {
+            bool result = data_available() >= count;
+
+            if (result)
+            {
+                if (elem_array)
+                {
+                    parent.buffer.peek_n(cursor, elem_array, count);
+                }
+                cursor += count;
+                parent.service_space();
+            }
+
+            return ToResult(result);
+        }
+
+        std::size_t try_pop_n_impl(element_t *elem_array, std::size_t count)
+        {
+            count = std::min(count, data_available());
+
+            if (count)
+            {
+                pop_n_impl(elem_array, count);
+            }
+
+            return count;
+        }
+
+        std::size_t pop_all_impl(element_t *elem_array = nullptr)
+        {
+            return try_pop_n_impl(elem_array, data_available());
+        }
+
+        void poll_metrics(uint32_t &_lapped, bool reset = true)
+        {
+            _lapped = lapped;
+
+            if (reset)
+            {
+                lapped = 0;
+            }
+        }
+
+      protected:
+        BroadcastBuffer &parent;
+        uint32_t cursor;
+
+        /* Elements overwritten before they were read. */
+        uint32_t lapped;
+
+        bool attached;
+
+        /* Skip ahead if the writer lapped this reader. */
+        inline void catch_up(void)
+        {
+            uint32_t behind = parent.buffer.write_cursor() - cursor;
+            if (behind > depth)
+            {
+                lapped += behind - depth;
+                cursor += behind - depth;
+            }
+        }
+
+        friend class BroadcastBuffer;
+    };
+
+    BroadcastBuffer(bool _lap = false)
+        : buffer(), readers(), lap(_lap), space_available(nullptr),
+          data_available(nullptr), write_dropped(0)
+    {
+    }
+
+    /* Allow writes to overwrite data slow readers haven't read yet. */
+    inline void set_lap(bool enable = true)
+    {
+        lap = enable;
+    }
+
+    void set_space_available(ServiceCallback _space_available = nullptr)
+    {
+        /* Don't allow double assignment. */
+        assert(not _space_available or
+               (_space_available and space_available == nullptr));
+        space_available = _space_available;
+    }
+
+    void set_data_available(ServiceCallback _data_available = nullptr)
+    {
+        /* Don't allow double assignment. */
+        assert(not _data_available or
+               (_data_available and data_available == nullptr));
+        data_available = _data_available;
+    }
+
+    /* Space is limited by the slowest reader (unless lapping). */
+    std::size_t space(void)
+    {
+        if (lap)
+        {
+            return depth;
+        }
+
+        uint32_t write_cursor = buffer.write_cursor();
+        std::size_t behind = 0;
+
+        for (auto reader : readers)
+        {
+            if (reader)
+            {
+                behind = std::max<std::size_t>(behind,
+                                               write_cursor - reader->cursor);
+            }
+        }
+
+        return depth - std::min(behind, depth);
+    }
+
+    inline bool full(void)
+    {
+        return space() == 0;
+    }
+
+    std::size_t num_readers(void)
+    {
+        return std::ranges::count_if(
+            readers, [](const Reader *reader) { return reader != nullptr; });
+    }
+
+    Result push_impl(const element_t elem, bool drop = false)
+    {
+        return push_n_impl(&elem, 1, drop);
+    }
+
+    void push_blocking_impl(const element_t elem)
+    {
+        push_n_blocking_impl(&elem, 1);
+    }
+
+    Result push_n_impl(const element_t *elem_array, std::size_t count,
+                       bool drop = false)
+    {
+        bool result = space() >= count;
+
+        if (result)
+        {
+            buffer.write_n(elem_array, count);
+            service_data();
+        }
+        else if (drop)
+        {
+            write_dropped += count;
+        }
+
+        return ToResult(result);
+    }
+
+    std::size_t try_push_n_impl(const element_t *elem_array, std::size_t count)
+    {
+        count = std::min(count, space());
+
+        if (count)
+        {
+            push_n_impl(elem_array, count);
+        }
+
+        return count;
+    }
+
+    void push_n_blocking_impl(const element_t *elem_array, std::size_t count)
+    {
+        std::size_t chunk;
+        while (count)
+        {
+            chunk = std::min(depth, count);
+
+            while (space() < chunk)
+            {
+                service_data(true);
+            }
+
+            push_n_impl(elem_array, chunk);
+            elem_array += chunk;
+            count -= chunk;
+        }
+    }
+
+    void poll_metrics(uint16_t &_write_dropped, bool reset = true)
+    {
+        _write_dropped = write_dropped;
+
+        if (reset)
+        {
+            write_dropped = 0;
+        }
+    }
+
+  protected:
+    CircularBuffer<depth, element_t> buffer;
+    std::array<Reader *, max_readers> readers;
+
+    bool lap;
+
+    ServiceCallback space_available;
+    ServiceCallback data_available;
+
+    uint16_t write_dropped;
+
+    bool attach(Reader *reader)
+    {
+        auto it = std::ranges::find(readers, nullptr);
+        bool result = it != readers.end();
+
+        if (result)
+        {
+            *it = reader;
+        }
+
+        return result;
+    }
+
+    void detach(Reader *reader)
+    {
+        std::ranges::replace(readers, reader, nullptr);
+    }
+
+    inline void service_data(bool required = false)
+    {
+        (void)required;
+        assert(data_available or not required);
+
+        if (data_available)
+        {
+            data_available(this);
+        }
+    }
+
+    inline void service_space(void)
+    {
+        if (space_available)
+        {
+            space_available(this);
+        }
+    }
+};
+
+} // namespace Coral
@@ -9,6 +9,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <span>
 
 /* internal */
 #include "../generated/structs/BufferState.h"
@@ -72,11 +73,91 @@ class CircularBuffer
         return state.read_cursor % depth;
     }
 
+    /* The absolute (not wrapped) position of the next element to write. */
+    inline uint32_t write_cursor(void)
+    {
+        return state.write_cursor;
+    }
+
+    /* The absolute (not wrapped) position of the next element to read. */
+    inline uint32_t read_cursor(void)
+    {
+        return state.read_cursor;
+    }
+
+    /* Discard elements (they aren't counted as read). */
+    inline void skip(std::size_t count)
+    {
+        state.read_cursor += count;
+    }
+
     inline element_t peek(void)
     {
         return buffer[read_index()];
     }
 
+    /*
+     * Get the elements that can be read (up to 'available') without
+     * wrapping around the end of the underlying, linear buffer.
+     */
+    inline std::span<element_t> read_region(std::size_t available)
+    {
+        return std::span<element_t>(
+            &(buffer.data()[read_index()]),
+            std::min(available, depth - read_index()));
+    }
+
+    /*
+     * Get the elements (up to 'available') starting at an absolute cursor
+     * without wrapping or consuming them (e.g. for independent readers).
+     */
+    inline std::span<element_t> region_at(uint32_t cursor,
+                                          std::size_t available)
+    {
+        std::size_t index = cursor % depth;
+        return std::span<element_t>(&(buffer.data()[index]),
+                                    std::min(available, depth - index));
+    }
+
+    /* Copy elements starting at an absolute cursor (without consuming). */
+    inline void peek_n(uint32_t cursor, element_t *elem_array,
+                       std::size_t count)
+    {
+        while (count)
+        {
+            auto region = region_at(cursor, count);
+            std::memcpy(elem_array, region.data(), region.size_bytes());
+
+            elem_array += region.size();
+            cursor += region.size();
+            count -= region.size();
+        }
+    }
+
+    /*
+     * Get the elements that can be written (up to 'space') without wrapping
+     * around the end of the underlying, linear buffer. Elements can be
+     * written in place and then committed with 'commit_write'.
+     */
+    inline std::span<element_t> write_region(std::size_t space)
+    {
+        return std::span<element_t>(
+            &(buffer.data()[write_index()]),
+            std::min(space, depth - write_index()));
+    }
+
+    inline void commit_write(std::size_t count)
+    {
+        state.write_cursor += count;
+        state.write_count += count;
+    }
+
+    /* The underlying, linear buffer. */
+    inline std::span<element_t, depth> storage(void)
+    {
+        return buffer;
+    }
+
     inline void read_single(element_t &elem)
     {
         elem = peek();
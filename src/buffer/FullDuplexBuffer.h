@@ -1,5 +1,9 @@
 #pragma once
 
+/* toolchain */
+#include <algorithm>
+#include <chrono>
+
 /* internal */
 #include "PcBuffer.h"
 
@@ -15,7 +19,9 @@ class FullDuplexBuffer
     using RxBuffer = PcBuffer<rx_depth, element_t>;
 
     FullDuplexBuffer(bool _auto_service = true)
-        : tx(_auto_service), rx(_auto_service)
+        : tx(_auto_service), rx(_auto_service), coalesce_threshold(0),
+          coalesce_deadline(0), holding(false), held_since(), deferred(0),
+          deadline_flushes(0)
     {
         /*
          * Attempt to service the writing end whenever data is ready to be
@@ -40,9 +46,34 @@ class FullDuplexBuffer
         service_rx(&rx);
     }
 
+    /*
+     * Hold transmit data until at least 'threshold' elements are buffered
+     * or the oldest held data is 'deadline_us' old (a threshold of zero
+     * disables coalescing). Deadlines are only checked when the transmit
+     * end is serviced (e.g. by 'dispatch').
+     */
+    void set_coalescing(std::size_t threshold, uint32_t deadline_us)
+    {
+        coalesce_threshold = std::min(threshold, tx_depth);
+        coalesce_deadline = std::chrono::microseconds(deadline_us);
+        holding = false;
+    }
+
+    /* Service the transmit end now (e.g. for latency-critical data). */
+    inline void flush_tx(void)
+    {
+        write_tx(&tx);
+    }
+
     inline void service_tx(TxBuffer *buf)
     {
-        static_cast<T *>(this)->service_tx_impl(buf);
+        /* Held data goes out when the buffer is explicitly flushed. */
+        if (coalesce_threshold and not buf->flushing() and hold(buf))
+        {
+            return;
+        }
+
+        write_tx(buf);
     }
 
     inline void service_rx(RxBuffer *buf)
@@ -50,8 +81,85 @@ class FullDuplexBuffer
         static_cast<T *>(this)->service_rx_impl(buf);
     }
 
+    void poll_coalescing_metrics(uint32_t &_deferred,
+                                 uint32_t &_deadline_flushes,
+                                 bool reset = true)
+    {
+        _deferred = deferred;
+        _deadline_flushes = deadline_flushes;
+
+        if (reset)
+        {
+            deferred = 0;
+            deadline_flushes = 0;
+        }
+    }
+
     TxBuffer tx;
     RxBuffer rx;
+
+  protected:
+    using Clock = std::chrono::steady_clock;
+
+    std::size_t coalesce_threshold;
+    Clock::duration coalesce_deadline;
+
+    /* When the currently held data started waiting. */
+    bool holding;
+    Clock::time_point held_since;
+
+    /* Metrics. */
+    uint32_t deferred;
+    uint32_t deadline_flushes;
+
+    inline void write_tx(TxBuffer *buf)
+    {
+        static_cast<T *>(this)->service_tx_impl(buf);
+
+        /* Data left over from a partial write keeps its original deadline. */
+        if (buf->empty())
+        {
+            holding = false;
+        }
+    }
+
+    /* Determine whether transmit data should keep waiting. */
+    bool hold(TxBuffer *buf)
+    {
+        if (buf->empty())
+        {
+            holding = false;
+            return true;
+        }
+
+        bool below = buf->state.data_available() < coalesce_threshold;
+
+        /* Start timing the oldest unwritten data. */
+        if (not holding)
+        {
+            holding = true;
+            held_since = Clock::now();
+
+            if (below)
+            {
+                deferred++;
+            }
+            return below;
+        }
+
+        if (not below)
+        {
+            return false;
+        }
+
+        if (Clock::now() - held_since >= coalesce_deadline)
+        {
+            deadline_flushes++;
+            return false;
+        }
+
+        return true;
+    }
 };
 
 } // namespace Coral
@@ -0,0 +1,275 @@
+/**
+ * \file
+ * \brief A block-oriented (double or N-way) producer-consumer buffer.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+/* internal */
+#include "PcBufferReader.h"
+
+namespace Coral
+{
+
+/**
+ * Passes whole blocks from a producer to a consumer (i.e. ping-pong or
+ * double buffering when there are two blocks). The producer acquires a
+ * free block, fills as much of it as it likes in place (e.g. with DMA or a
+ * single read(2)) and publishes it. There's no per-element accounting on
+ * the producing side.
+ *
+ * The consumer can drain whole blocks in place and release them, or read
+ * elements through the \ref PcBufferReader interface (e.g. with
+ * \ref Cobs::MessageDecoder::dispatch), which releases blocks as they're
+ * emptied.
+ *
+ * The producer and consumer may run on different threads (or in an
+ * interrupt). Callbacks run in the context of the side that triggers them.
+ *
+ * \tparam block_size The number of elements in each block.
+ * \tparam num_blocks The number of blocks.
+ * \tparam element_t  The kind of element buffered.
+ */
+template <std::size_t block_size, std::size_t num_blocks = 2,
+          typename element_t = std::byte>
+class MultiBuffer
+    : public PcBufferReader<MultiBuffer<block_size, num_blocks, element_t>,
+                            element_t>
+{
+    static_assert(block_size and num_blocks >= 2);
+
+  public:
+    using ServiceCallback = std::function<void(MultiBuffer *)>;
+
+    MultiBuffer(ServiceCallback _space_available = nullptr,
+                ServiceCallback _data_available = nullptr)
+        : blocks(), lengths(), head(0), tail(0), offset(0),
+          space_available(_space_available), data_available(_data_available),
+          overruns(0), published(0)
+    {
+    }
+
+    void set_space_available(ServiceCallback _space_available = nullptr)
+    {
+        /* Don't allow double assignment. */
+        assert(not _space_available or
+               (_space_available and space_available == nullptr));
+        space_available = _space_available;
+    }
+
+    void set_data_available(ServiceCallback _data_available = nullptr)
+    {
+        /* Don't allow double assignment. */
+        assert(not _data_available or
+               (_data_available and data_available == nullptr));
+        data_available = _data_available;
+    }
+
+    /*
+     * Producer: get the next block to fill. This is empty when every block
+     * is still waiting to be drained (the producer can wait and try again,
+     * or discard its data with 'drop').
+     */
+    std::span<element_t> acquire_fill(void)
+    {
+        std::size_t index = head.load(std::memory_order_relaxed);
+
+        if (index - tail.load(std::memory_order_acquire) >= num_blocks)
+        {
+            return std::span<element_t>();
+        }
+
+        return std::span<element_t>(blocks[index % num_blocks]);
+    }
+
+    /*
+     * Producer: record that a block of data was discarded (an overrun),
+     * e.g. because no block could be acquired in time.
+     */
+    inline void drop(void)
+    {
+        overruns++;
+    }
+
+    /*
+     * Producer: hand off the acquired block, of which the first 'count'
+     * elements were filled. Publishing nothing keeps the block acquired.
+     */
+    void publish(std::size_t count = block_size)
+    {
+        assert(count <= block_size);
+
+        if (count)
+        {
+            std::size_t index = head.load(std::memory_order_relaxed);
+            lengths[index % num_blocks] = count;
+            head.store(index + 1, std::memory_order_release);
+
+            published++;
+            service_data();
+        }
+    }
+
+    /* Producer: the number of blocks that can be acquired for filling. */
+    inline std::size_t free_blocks(void)
+    {
+        return num_blocks - (head.load(std::memory_order_relaxed) -
+                             tail.load(std::memory_order_acquire));
+    }
+
+    /*
+     * Consumer: get the unread elements of the oldest published block
+     * (empty if there isn't one).
+     */
+    std::span<const element_t> acquire_drain(void)
+    {
+        std::size_t index = tail.load(std::memory_order_relaxed);
+
+        if (index == head.load(std::memory_order_acquire))
+        {
+            return std::span<const element_t>();
+        }
+
+        std::size_t slot = index % num_blocks;
+        return std::span<const element_t>(blocks[slot].data() + offset,
+                                          lengths[slot] - offset);
+    }
+
+    /* Consumer: return the oldest block (and anything unread in it). */
+    void release(void)
+    {
+        assert(tail.load(std::memory_order_relaxed) !=
+               head.load(std::memory_order_acquire));
+
+        offset = 0;
+        tail.store(tail.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+
+        service_space();
+    }
+
+    /* Consumer: the number of published blocks not yet released. */
+    inline std::size_t ready_blocks(void)
+    {
+        return head.load(std::memory_order_acquire) -
+               tail.load(std::memory_order_relaxed);
+    }
+
+    /* Consumer: the number of elements that can be read. */
+    std::size_t available(void)
+    {
+        std::size_t index = tail.load(std::memory_order_relaxed);
+        std::size_t end = head.load(std::memory_order_acquire);
+
+        std::size_t result = 0;
+        for (; index != end; index++)
+        {
+            result += lengths[index % num_blocks];
+        }
+
+        return (result) ? result - offset : 0;
+    }
+
+    Result pop_impl(element_t &elem)
+    {
+        return pop_n_impl(&elem, 1);
+    }
+
+    Result pop_n_impl(element_t *elem_array, std::size_t count)
+    {
+        bool result = available() >= count;
+
+        while (result and count)
+        {
+            auto region = acquire_drain();
+            std::size_t chunk = std::min(count, region.size());
+
+            if (elem_array)
+            {
+                std::copy_n(region.data(), chunk, elem_array);
+                elem_array += chunk;
+            }
+            count -= chunk;
+            offset += chunk;
+
+            if (chunk == region.size())
+            {
+                release();
+            }
+        }
+
+        return ToResult(result);
+    }
+
+    std::size_t try_pop_n_impl(element_t *elem_array, std::size_t count)
+    {
+        count = std::min(count, available());
+
+        if (count)
+        {
+            pop_n_impl(elem_array, count);
+        }
+
+        return count;
+    }
+
+    std::size_t pop_all_impl(element_t *elem_array = nullptr)
+    {
+        return try_pop_n_impl(elem_array, available());
+    }
+
+    /*
+     * Get the number of blocks the producer dropped and the number it
+     * published.
+     */
+    void poll_metrics(uint32_t &_overruns, uint32_t &_published,
+                      bool reset = true)
+    {
+        _overruns = (reset) ? overruns.exchange(0) : overruns.load();
+        _published = (reset) ? published.exchange(0) : published.load();
+    }
+
+  protected:
+    std::array<std::array<element_t, block_size>, num_blocks> blocks;
+    std::array<std::size_t, num_blocks> lengths;
+
+    /* Blocks published (producer) and released (consumer). */
+    std::atomic<std::size_t> head;
+    std::atomic<std::size_t> tail;
+
+    /* Elements already read from the oldest block (consumer). */
+    std::size_t offset;
+
+    ServiceCallback space_available;
+    ServiceCallback data_available;
+
+    /* Metrics. */
+    std::atomic<uint32_t> overruns;
+    std::atomic<uint32_t> published;
+
+    inline void service_data(void)
+    {
+        if (data_available)
+        {
+            data_available(this);
+        }
+    }
+
+    inline void service_space(void)
+    {
+        if (space_available)
+        {
+            space_available(this);
+        }
+    }
+};
+
+} // namespace Coral
@@ -5,6 +5,7 @@
 #pragma once
 
 /* toolchain */
+#include <algorithm>
 #include <functional>
 
 /* internal */
@@ -27,7 +28,8 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
              ServiceCallback _space_available = nullptr,
              ServiceCallback _data_available = nullptr)
         : state(depth), buffer(), space_available(_space_available),
-          data_available(_data_available), auto_service(_auto_service)
+          data_available(_data_available), auto_service(_auto_service),
+          overwrite(false), is_flushing(false), laps(0)
     {
     }
 
@@ -47,6 +49,28 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
         data_available = _data_available;
     }
 
+    /*
+     * Make writes always succeed by discarding the oldest elements when the
+     * buffer is full (e.g. to keep a fixed-size, recent history). Overwriting
+     * moves the read position from the writing side, so the producer and
+     * consumer must run on the same thread in this mode.
+     */
+    inline void set_overwrite(bool enable = true)
+    {
+        overwrite = enable;
+    }
+
+    /*
+     * Get the number of elements overwritten before they could be read
+     * since the last call (i.e. how far the reader was lapped).
+     */
+    inline std::size_t lapped(void)
+    {
+        std::size_t result = laps;
+        laps = 0;
+        return result;
+    }
+
     inline bool empty(void)
     {
         return state.empty();
@@ -61,6 +85,7 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
     {
         /* Reset state. */
         state.reset();
+        laps = 0;
 
         uint32_t tmp;
         buffer.poll_metrics(tmp, tmp);
@@ -71,6 +96,72 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
         return buffer.peek();
     }
 
+    /*
+     * Get the contiguous region of readable elements starting at the read
+     * cursor (empty if there's no data). Elements can be read in place and
+     * then consumed with a null-array pop_n.
+     */
+    inline std::span<element_t> read_region(void)
+    {
+        return buffer.read_region(state.data_available());
+    }
+
+    /*
+     * Find the first occurrence of an element among the readable elements,
+     * starting 'start' elements after the read cursor (nothing is
+     * consumed). Sets 'index' (relative to the read cursor) if found.
+     */
+    bool find(const element_t elem, std::size_t &index, std::size_t start = 0)
+    {
+        std::size_t available = state.data_available();
+        uint32_t cursor = buffer.read_cursor();
+
+        while (start < available)
+        {
+            auto region = buffer.region_at(cursor + start, available - start);
+            auto it = std::ranges::find(region, elem);
+
+            if (it != region.end())
+            {
+                index = start + (it - region.begin());
+                return true;
+            }
+
+            start += region.size();
+        }
+
+        return false;
+    }
+
+    /*
+     * Get the contiguous region of writable elements starting at the write
+     * cursor (empty if there's no space). Elements can be written in place
+     * (e.g. by asynchronous I/O) and then added with 'commit_write'.
+     */
+    inline std::span<element_t> write_region(void)
+    {
+        return buffer.write_region(state.space_available());
+    }
+
+    Result commit_write(std::size_t count)
+    {
+        auto result = state.increment_data(false, count);
+
+        if (result)
+        {
+            buffer.commit_write(count);
+            service_data();
+        }
+
+        return ToResult(result);
+    }
+
+    /* The underlying storage (e.g. for registering with the kernel). */
+    inline std::span<element_t, depth> storage(void)
+    {
+        return buffer.storage();
+    }
+
     Result pop_impl(element_t &elem)
     {
         /* Allow a pop request to feed the buffer. */
@@ -136,6 +227,11 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
             service_data();
         }
 
+        if (overwrite)
+        {
+            make_room(1);
+        }
+
         auto result = state.increment_data(drop);
 
         if (result)
@@ -149,19 +245,34 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
 
     void push_blocking_impl(const element_t elem)
     {
-        while (full())
+        while (full() and not overwrite)
         {
             service_data(true);
         }
         push_impl(elem);
     }
 
-    inline void flush(void)
+    /*
+     * Service the consumer until the buffer is empty (or until 'attempts'
+     * services, if non-zero). Consumers that hold data back (e.g. to coalesce
+     * writes) should write it out regardless while 'flushing' is set. Returns
+     * whether the buffer was emptied.
+     */
+    inline bool flush(std::size_t attempts = 0)
     {
-        while (!empty())
+        is_flushing = true;
+        for (std::size_t i = 0; !empty() and (!attempts or i < attempts); i++)
         {
             service_data(true);
         }
+        is_flushing = false;
+
+        return empty();
+    }
+
+    inline bool flushing(void)
+    {
+        return is_flushing;
     }
 
     Result push_n_impl(const element_t *elem_array, std::size_t count,
@@ -172,6 +283,22 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
             service_data();
         }
 
+        if (overwrite)
+        {
+            /* Only the newest elements can be kept. */
+            if (count > depth)
+            {
+                std::size_t skip = count - depth;
+                state.overwritten += skip;
+                laps += skip;
+
+                elem_array += skip;
+                count = depth;
+            }
+
+            make_room(count);
+        }
+
         auto result = state.increment_data(drop, count);
         if (result)
         {
@@ -184,7 +311,10 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
 
     std::size_t try_push_n_impl(const element_t *elem_array, std::size_t count)
     {
-        count = std::min(count, state.space_available());
+        if (not overwrite)
+        {
+            count = std::min(count, state.space_available());
+        }
 
         if (count)
         {
@@ -201,7 +331,7 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
         {
             chunk = std::min(depth, count);
 
-            while (!state.has_enough_space(chunk))
+            while (!state.has_enough_space(chunk) and not overwrite)
             {
                 service_data(true);
             }
@@ -221,6 +351,22 @@ class PcBuffer : public PcBufferWriter<PcBuffer<depth, element_t>, element_t>,
     ServiceCallback data_available;
 
     bool auto_service;
+    bool overwrite;
+    bool is_flushing;
+
+    /* Elements overwritten since the reader last checked. */
+    std::size_t laps;
+
+    /* Discard the oldest elements so that 'count' more fit. */
+    inline void make_room(std::size_t count)
+    {
+        std::size_t discard = state.overwrite(count);
+        if (discard)
+        {
+            buffer.skip(discard);
+            laps += discard;
+        }
+    }
 
     inline void service_data(bool required = false)
     {
@@ -254,24 +400,48 @@ template <std::size_t depth> using WcharBuffer = PcBuffer<depth, wchar_t>;
  * Stream interfaces.
  */
 
+/* Read (without blocking) as much as there's space for. */
 template <std::size_t depth, typename element_t = std::byte>
 inline std::basic_istream<element_t> &operator>>(
     std::basic_istream<element_t> &stream,
     PcBuffer<depth, element_t> &instance)
 {
-    std::array<element_t, depth> elem_array;
-    instance.push_n_blocking(elem_array.data(),
-                             stream.readsome(elem_array.data(), depth));
+    while (true)
+    {
+        auto region = instance.write_region();
+        std::streamsize count =
+            (region.empty()) ? 0
+                             : stream.readsome(region.data(), region.size());
+
+        if (count <= 0)
+        {
+            break;
+        }
+
+        instance.commit_write(count);
+    }
+
     return stream;
 }
 
+/* Write (and consume) all available elements. */
 template <std::size_t depth, typename element_t = std::byte>
 inline std::basic_ostream<element_t> &operator<<(
     std::basic_ostream<element_t> &stream,
     PcBuffer<depth, element_t> &instance)
 {
-    std::array<element_t, depth> elem_array;
-    stream.write(elem_array.data(), instance.try_pop_n(elem_array));
+    while (true)
+    {
+        auto region = instance.read_region();
+        if (region.empty())
+        {
+            break;
+        }
+
+        stream.write(region.data(), region.size());
+        instance.pop_n(nullptr, region.size());
+    }
+
     return stream;
 }
 
@@ -14,7 +14,7 @@ struct PcBufferState
 {
     PcBufferState(std::size_t _size)
         : size(_size), data(0), space(_size), high_watermark(0),
-          write_dropped(0)
+          write_dropped(0), overwritten(0)
     {
     }
 
@@ -27,6 +27,7 @@ struct PcBufferState
         /* Reset stats. */
         high_watermark = 0;
         write_dropped = 0;
+        overwritten = 0;
     }
 
     inline bool has_enough_space(std::size_t count)
@@ -55,6 +56,21 @@ struct PcBufferState
         return result;
     }
 
+    /*
+     * Make space for 'count' (no more than 'size') elements by discarding
+     * the oldest data. Returns the number of elements discarded.
+     */
+    std::size_t overwrite(std::size_t count)
+    {
+        std::size_t discard = (count > space) ? count - space : 0;
+
+        data -= discard;
+        space += discard;
+        overwritten += discard;
+
+        return discard;
+    }
+
     inline bool has_enough_data(std::size_t count)
     {
         return data >= count;
@@ -85,6 +101,18 @@ struct PcBufferState
         }
     }
 
+    void poll_metrics(uint16_t &_high_watermark, uint16_t &_write_dropped,
+                      uint32_t &_overwritten, bool reset = true)
+    {
+        _overwritten = overwritten;
+        if (reset)
+        {
+            overwritten = 0;
+        }
+
+        poll_metrics(_high_watermark, _write_dropped, reset);
+    }
+
     inline bool empty(void)
     {
         return data == 0;
@@ -112,6 +140,7 @@ struct PcBufferState
 
     uint16_t high_watermark;
     uint16_t write_dropped;
+    uint32_t overwritten;
 };
 
 }; // namespace Coral
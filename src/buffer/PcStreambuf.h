@@ -0,0 +1,118 @@
+/**
+ * \file
+ * \brief A stream-buffer adapter for producer-consumer buffers.
+ */
+#pragma once
+
+/* toolchain */
+#include <streambuf>
+
+/* internal */
+#include "PcBuffer.h"
+
+namespace Coral
+{
+
+/**
+ * Lets iostreams read from and write to a \ref PcBuffer in place: the get
+ * area is the buffer's contiguous readable region and the put area is its
+ * contiguous writable region (no intermediate copies).
+ *
+ * Elements read through the get area are consumed, and elements written to
+ * the put area are added, when the areas are exhausted or the stream is
+ * synchronized (e.g. flushed). While a put area is outstanding, nothing else
+ * should write to the buffer.
+ */
+template <std::size_t depth, typename element_t = char>
+class PcStreambuf : public std::basic_streambuf<element_t>
+{
+  public:
+    using Buffer = PcBuffer<depth, element_t>;
+    using traits_type = typename std::basic_streambuf<element_t>::traits_type;
+    using int_type = typename traits_type::int_type;
+
+    PcStreambuf(Buffer &_buffer) : buffer(_buffer)
+    {
+    }
+
+    ~PcStreambuf()
+    {
+        sync();
+    }
+
+  protected:
+    Buffer &buffer;
+
+    /* Consume elements read through the get area. */
+    void commit_get(void)
+    {
+        std::size_t count = this->gptr() - this->eback();
+        if (count)
+        {
+            buffer.pop_n(nullptr, count);
+        }
+        this->setg(this->gptr(), this->gptr(), this->egptr());
+    }
+
+    /* Add elements written to the put area. */
+    void commit_put(void)
+    {
+        std::size_t count = this->pptr() - this->pbase();
+        if (count)
+        {
+            buffer.commit_write(count);
+        }
+        this->setp(this->pptr(), this->epptr());
+    }
+
+    int sync() override
+    {
+        commit_get();
+        commit_put();
+        return 0;
+    }
+
+    std::streamsize showmanyc() override
+    {
+        return buffer.state.data_available() -
+               (this->gptr() - this->eback());
+    }
+
+    int_type underflow() override
+    {
+        commit_get();
+
+        auto region = buffer.read_region();
+        if (region.empty())
+        {
+            return traits_type::eof();
+        }
+
+        this->setg(region.data(), region.data(),
+                   region.data() + region.size());
+        return traits_type::to_int_type(*this->gptr());
+    }
+
+    int_type overflow(int_type elem) override
+    {
+        commit_put();
+
+        auto region = buffer.write_region();
+        if (region.empty())
+        {
+            return traits_type::eof();
+        }
+
+        this->setp(region.data(), region.data() + region.size());
+
+        if (not traits_type::eq_int_type(elem, traits_type::eof()))
+        {
+            *this->pptr() = traits_type::to_char_type(elem);
+            this->pbump(1);
+        }
+
+        return traits_type::not_eof(elem);
+    }
+};
+
+} // namespace Coral
@@ -0,0 +1,231 @@
+/**
+ * \file
+ * \brief A token-bucket rate limiter for producer-consumer buffer writers.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+/* internal */
+#include "../result.h"
+#include "PcBufferWriter.h"
+
+namespace Coral
+{
+
+/**
+ * Limits how fast elements can be written to another writer (e.g. a
+ * \ref PcBuffer). Every element written costs a token and tokens accumulate
+ * at 'rate' per second, up to 'burst'.
+ *
+ * Non-blocking writes fail (or write less) when there aren't enough tokens,
+ * blocking writes sleep until there are. A non-blocking 'push_n' of more than
+ * 'burst' elements can never be covered, so it always fails (use 'try_push_n'
+ * or a blocking write instead). The clock is only read when the available
+ * tokens don't already cover a write.
+ *
+ * \tparam Writer    The kind of writer to forward elements to.
+ * \tparam element_t The kind of element written.
+ * \tparam Clock     A monotonic clock (std::chrono interface).
+ */
+template <class Writer, typename element_t = std::byte,
+          class Clock = std::chrono::steady_clock>
+class RateLimitedWriter
+    : public PcBufferWriter<RateLimitedWriter<Writer, element_t, Clock>,
+                            element_t>
+{
+  public:
+    RateLimitedWriter(Writer &_output, uint32_t _rate, uint32_t _burst)
+        : output(_output), rate(), burst(), tokens(0), last(Clock::now()),
+          throttled(0), throttle_time(0)
+    {
+        configure(_rate, _burst);
+    }
+
+    /* Set the rate (elements per second) and burst size (start full). */
+    void configure(uint32_t _rate, uint32_t _burst)
+    {
+        rate = std::max<uint32_t>(_rate, 1);
+        burst = std::max<uint32_t>(_burst, 1);
+        tokens = burst;
+        last = Clock::now();
+    }
+
+    /* The number of elements that can be written right now. */
+    inline std::size_t available(void)
+    {
+        refill();
+        return tokens;
+    }
+
+    Result push_impl(const element_t elem, bool drop = false)
+    {
+        return push_n_impl(&elem, 1, drop);
+    }
+
+    Result push_n_impl(const element_t *elem_array, std::size_t count,
+                       bool drop = false)
+    {
+        /* Larger writes aren't throttled, they're impossible. */
+        if (count > burst)
+        {
+            return FAIL;
+        }
+
+        bool result = acquire(count) and
+                      ToBool(output.push_n(elem_array, count, drop));
+
+        if (result)
+        {
+            tokens -= count;
+        }
+
+        return ToResult(result);
+    }
+
+    std::size_t try_push_n_impl(const element_t *elem_array, std::size_t count)
+    {
+        if (tokens < count)
+        {
+            refill();
+            if (tokens < count)
+            {
+                count = tokens;
+                throttled++;
+            }
+        }
+
+        count = (count) ? output.try_push_n(elem_array, count) : 0;
+        tokens -= count;
+
+        return count;
+    }
+
+    void push_blocking_impl(const element_t elem)
+    {
+        push_n_blocking_impl(&elem, 1);
+    }
+
+    void push_n_blocking_impl(const element_t *elem_array, std::size_t count)
+    {
+        while (count)
+        {
+            std::size_t chunk = std::min<std::size_t>(count, burst);
+
+            wait(chunk);
+            output.push_n_blocking(elem_array, chunk);
+            tokens -= chunk;
+
+            elem_array += chunk;
+            count -= chunk;
+        }
+    }
+
+    /*
+     * Get the number of writes that were limited and the time (in
+     * microseconds) blocking writes spent waiting for tokens (non-blocking
+     * writes never wait, so they only add to the former).
+     */
+    void poll_metrics(uint32_t &_throttled, uint32_t &_throttle_time,
+                      bool reset = true)
+    {
+        _throttled = throttled;
+        _throttle_time = throttle_time;
+
+        if (reset)
+        {
+            throttled = 0;
+            throttle_time = 0;
+        }
+    }
+
+  protected:
+    Writer &output;
+
+    uint32_t rate;
+    uint32_t burst;
+    uint32_t tokens;
+
+    /* When tokens were last added (to the nearest whole token). */
+    typename Clock::time_point last;
+
+    /* Metrics. */
+    uint32_t throttled;
+    uint32_t throttle_time;
+
+    using nanoseconds = std::chrono::nanoseconds;
+    static constexpr uint64_t ns_per_second = 1000000000;
+
+    void refill(void)
+    {
+        auto now = Clock::now();
+        uint64_t elapsed =
+            std::chrono::duration_cast<nanoseconds>(now - last).count();
+
+        /*
+         * Past the time to fill the bucket (rounded up), more time adds
+         * nothing (this also keeps the product below from overflowing).
+         */
+        uint64_t fill_time =
+            (uint64_t(burst) * ns_per_second + rate - 1) / rate;
+        elapsed = std::min(elapsed, fill_time);
+
+        uint64_t added = elapsed * rate / ns_per_second;
+
+        if (tokens + added >= burst)
+        {
+            tokens = burst;
+            last = now;
+        }
+        else if (added)
+        {
+            /* Keep the remainder (partial tokens) for the next refill. */
+            tokens += added;
+            last += std::chrono::duration_cast<typename Clock::duration>(
+                nanoseconds(added * ns_per_second / rate));
+        }
+    }
+
+    /* Check for 'count' tokens (without waiting). */
+    inline bool acquire(std::size_t count)
+    {
+        if (tokens < count)
+        {
+            refill();
+            if (tokens < count)
+            {
+                throttled++;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* Wait until there are at least 'count' (no more than 'burst') tokens. */
+    void wait(std::size_t count)
+    {
+        if (acquire(count))
+        {
+            return;
+        }
+
+        auto start = Clock::now();
+
+        while (tokens < count)
+        {
+            std::this_thread::sleep_for(
+                nanoseconds((count - tokens) * ns_per_second / rate));
+            refill();
+        }
+
+        throttle_time += std::chrono::duration_cast<std::chrono::microseconds>(
+                             Clock::now() - start)
+                             .count();
+    }
+};
+
+} // namespace Coral
@@ -0,0 +1,338 @@
+/**
+ * \file
+ * \brief A frame-aware transmit scheduler for multiple buffers.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+/* internal */
+#include "PcBuffer.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_tx_queues = 4;
+static constexpr uint32_t default_tx_quantum = 256;
+
+/**
+ * Multiplexes several input queues onto one output (e.g. the transmit
+ * buffer of a \ref FullDuplexBuffer) a frame at a time, so that frames from
+ * different queues never interleave.
+ *
+ * Queues are scheduled by strict priority (0 is the highest): a queue is
+ * only served when no higher-priority queue has a complete frame. Queues of
+ * equal priority share the output with deficit round robin, in proportion
+ * to their quanta (in elements).
+ *
+ * A frame (including its delimiter) must fit in its queue. A frame that
+ * fills a queue without ending is dropped, along with the rest of it as
+ * it arrives.
+ *
+ * \tparam depth      The depth of each input queue.
+ * \tparam num_queues The number of input queues (and priority levels).
+ * \tparam element_t  The kind of element queued.
+ */
+template <std::size_t depth, std::size_t num_queues = default_tx_queues,
+          typename element_t = uint8_t>
+class TxScheduler
+{
+  public:
+    using Queue = PcBuffer<depth, element_t>;
+
+    /* COBS frames end with a zero. */
+    TxScheduler(element_t _delimiter = 0)
+        : queues(), classes(), delimiter(_delimiter), current(none),
+          remaining(0), cursors(), servicing(false)
+    {
+        cursors.fill(none);
+    }
+
+    inline Queue &operator[](std::size_t index)
+    {
+        return queues[index];
+    }
+
+    /* Set a queue's priority level and its share within that level. */
+    void configure(std::size_t index, std::size_t priority,
+                   uint32_t quantum = default_tx_quantum)
+    {
+        assert(index < num_queues and priority < num_queues and quantum);
+
+        classes[index].priority = priority;
+        classes[index].quantum = quantum;
+        classes[index].deficit = 0;
+    }
+
+    /*
+     * Service 'output' whenever queues receive data or it has space (e.g.
+     * as its contents are written out).
+     */
+    template <std::size_t out_depth>
+    void attach(PcBuffer<out_depth, element_t> &output)
+    {
+        for (auto &queue : queues)
+        {
+            queue.set_data_available([this, &output](Queue *buf) {
+                (void)buf;
+                service(output);
+            });
+        }
+
+        output.set_space_available(
+            [this](PcBuffer<out_depth, element_t> *buf) { service(*buf); });
+    }
+
+    /*
+     * Move complete frames from the queues to 'output' while it has space.
+     * A frame that doesn't fit is continued (before any other frame) the
+     * next time. Returns the number of elements moved.
+     */
+    template <std::size_t out_depth>
+    std::size_t service(PcBuffer<out_depth, element_t> &output)
+    {
+        /* Moving data can cause the output to service this again. */
+        if (servicing)
+        {
+            return 0;
+        }
+        servicing = true;
+
+        std::size_t moved = 0;
+
+        while (not output.full())
+        {
+            if (current == none and not select())
+            {
+                break;
+            }
+
+            auto &queue = queues[current];
+            auto region = queue.read_region();
+
+            std::size_t count = output.try_push_n(
+                region.data(), std::min(region.size(), remaining));
+            queue.pop_n(nullptr, count);
+
+            moved += count;
+            remaining -= count;
+            classes[current].elements += count;
+
+            if (remaining == 0)
+            {
+                classes[current].frames++;
+                current = none;
+            }
+        }
+
+        servicing = false;
+        return moved;
+    }
+
+    void poll_metrics(std::size_t index, uint32_t &frames,
+                      uint32_t &elements, bool reset = true)
+    {
+        auto &cls = classes[index];
+
+        frames = cls.frames;
+        elements = cls.elements;
+
+        if (reset)
+        {
+            cls.frames = 0;
+            cls.elements = 0;
+        }
+    }
+
+    /* Also get the number of frames discarded for not fitting a queue. */
+    void poll_metrics(std::size_t index, uint32_t &frames,
+                      uint32_t &elements, uint32_t &oversized,
+                      bool reset = true)
+    {
+        oversized = classes[index].oversized;
+
+        if (reset)
+        {
+            classes[index].oversized = 0;
+        }
+
+        poll_metrics(index, frames, elements, reset);
+    }
+
+  protected:
+    static constexpr std::size_t none = num_queues;
+
+    std::array<Queue, num_queues> queues;
+
+    struct Class
+    {
+        std::size_t priority = 0;
+        uint32_t quantum = default_tx_quantum;
+        uint32_t deficit = 0;
+        bool credited = false;
+
+        /* The length of the queue's next frame (zero if incomplete). */
+        std::size_t frame = 0;
+        std::size_t scanned = 0;
+
+        /* Whether the rest of a frame that didn't fit is being dropped. */
+        bool discarding = false;
+
+        /* Metrics. */
+        uint32_t frames = 0;
+        uint32_t elements = 0;
+        uint32_t oversized = 0;
+    };
+    std::array<Class, num_queues> classes;
+
+    element_t delimiter;
+
+    /* The queue whose frame is being moved (and how much is left). */
+    std::size_t current;
+    std::size_t remaining;
+
+    /* The queue being visited at each priority level. */
+    std::array<std::size_t, num_queues> cursors;
+
+    bool servicing;
+
+    /* Get the length of a queue's next complete frame (or zero). */
+    std::size_t frame_length(std::size_t index)
+    {
+        auto &cls = classes[index];
+        auto &queue = queues[index];
+
+        while (not cls.frame and not queue.empty())
+        {
+            std::size_t found;
+            bool complete = queue.find(delimiter, found, cls.scanned);
+
+            if (cls.discarding)
+            {
+                /* Drop through the end of the frame that didn't fit. */
+                queue.pop_n(nullptr, (complete)
+                                         ? found + 1
+                                         : queue.state.data_available());
+                cls.discarding = not complete;
+                cls.scanned = 0;
+            }
+            else if (complete)
+            {
+                cls.frame = found + 1;
+            }
+            else if (queue.full())
+            {
+                /*
+                 * A frame that fills the whole queue can never be
+                 * completed (and would stall the queue), drop it.
+                 */
+                cls.oversized++;
+                cls.discarding = true;
+            }
+            else
+            {
+                /* Don't scan the same elements again. */
+                cls.scanned = queue.state.data_available();
+                break;
+            }
+        }
+
+        return cls.frame;
+    }
+
+    /* Start moving a frame from the given queue. */
+    inline void start(std::size_t index)
+    {
+        auto &cls = classes[index];
+
+        current = index;
+        remaining = cls.frame;
+
+        cls.deficit -= cls.frame;
+        cls.frame = 0;
+        cls.scanned = 0;
+    }
+
+    /* The next queue with the same priority (round robin). */
+    std::size_t next(std::size_t index)
+    {
+        std::size_t priority = classes[index].priority;
+
+        do
+        {
+            index = (index + 1) % num_queues;
+        } while (classes[index].priority != priority);
+
+        return index;
+    }
+
+    bool select(void)
+    {
+        /* Find the highest priority level with a complete frame. */
+        std::size_t level = none;
+        for (std::size_t i = 0; i < num_queues; i++)
+        {
+            if (frame_length(i))
+            {
+                level = std::min(level, classes[i].priority);
+            }
+            else if (queues[i].empty())
+            {
+                /*
+                 * Idle queues don't accumulate credit (queues with a
+                 * partial frame keep theirs).
+                 */
+                classes[i].deficit = 0;
+            }
+        }
+
+        if (level == none)
+        {
+            return false;
+        }
+
+        std::size_t &cursor = cursors[level];
+        if (cursor == none or classes[cursor].priority != level)
+        {
+            cursor = std::ranges::find_if(classes,
+                                          [level](const Class &cls) {
+                                              return cls.priority == level;
+                                          }) -
+                     classes.begin();
+        }
+
+        /*
+         * Deficit round robin: a queue is credited its quantum once per
+         * visit and sends frames while its credit covers them. At least one
+         * queue at this level has a frame, so credit eventually suffices.
+         */
+        while (true)
+        {
+            auto &cls = classes[cursor];
+
+            if (cls.frame)
+            {
+                if (not cls.credited)
+                {
+                    cls.deficit += cls.quantum;
+                    cls.credited = true;
+                }
+
+                if (cls.deficit >= cls.frame)
+                {
+                    start(cursor);
+                    return true;
+                }
+            }
+
+            cls.credited = false;
+            cursor = next(cursor);
+        }
+    }
+};
+
+} // namespace Coral
@@ -0,0 +1,265 @@
+/**
+ * \file
+ * \brief A binary (COBS-framed) command application interface.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+/* internal */
+#include "../buffer/PcBuffer.h"
+#include "../buffer/cobs/Decoder.h"
+#include "../buffer/cobs/Encoder.h"
+#include "../logging/PrintfLogger.h"
+#include "../result.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_binary_commands = 16;
+static constexpr std::size_t default_binary_command_depth = 1024;
+static constexpr std::size_t default_binary_mtu = 256;
+static constexpr std::size_t default_binary_send_attempts = 64;
+
+/**
+ * Dispatches binary commands. Every frame is COBS encoded and contains a
+ * 16-bit identifier followed by an ifgen-generated structure (identified by
+ * its 'id' constant), both in 'endianness' byte order.
+ *
+ * Handlers are registered per structure type and are called with a decoded
+ * instance. A handler that returns a structure sends it as the response.
+ */
+template <std::size_t max_commands = default_binary_commands,
+          std::size_t depth = default_binary_command_depth,
+          std::size_t mtu = default_binary_mtu,
+          std::endian endianness = std::endian::little,
+          class T = PrintfLogger>
+class BinaryCommandApp : public HasLogInterface<T>
+{
+  public:
+    using Buffer = PcBuffer<depth, uint8_t>;
+    using Decoder = Cobs::MessageDecoder<mtu>;
+    using Handler = std::function<void(const uint8_t *)>;
+
+    static constexpr std::size_t header_size = sizeof(uint16_t);
+
+    BinaryCommandApp(Buffer &_rx, Buffer &_tx, LogInterface<T> *_log = nullptr)
+        : HasLogInterface<T>(_log), rx(_rx), tx(_tx),
+          decoder([this](const std::array<uint8_t, mtu> &frame,
+                         std::size_t size) { process(frame.data(), size); }),
+          commands(), command_index(0), unknown(0), malformed(0)
+    {
+        /* Decode frames whenever there's data. */
+        rx.set_data_available([this](Buffer *buf) {
+            (void)buf;
+            poll();
+        });
+    }
+
+    /*
+     * Register a handler for a structure type, called as
+     * 'handler(const Request &)'. If the handler returns a structure, it's
+     * sent as a response.
+     */
+    template <class Request, typename Function>
+    void add_handler(Function function, const char *help = nullptr,
+                     LogInterface<T> *_log = nullptr)
+    {
+        static_assert(header_size + Request::size <= mtu);
+        static_assert(std::is_invocable_v<Function, const Request &>);
+
+        uint16_t id = Request::id;
+
+        if (command_index >= max_commands)
+        {
+            this->log(_log,
+                      "Can't add handler for %u, all %zu slots are in use.\n",
+                      id, max_commands);
+            return;
+        }
+
+        /* Keep commands sorted by identifier (inserting in place). */
+        auto end = commands.begin() + command_index;
+        auto it = lower_bound(id);
+
+        if (it != end and it->id == id)
+        {
+            this->log(_log, "Command %u already registered.\n", id);
+            return;
+        }
+
+        std::move_backward(it, end, end + 1);
+        it->id = id;
+        it->size = Request::size;
+        it->help = help;
+        it->handler = [this, function](const uint8_t *payload) {
+            Request request;
+            request.decode(
+                reinterpret_cast<const typename Request::Buffer *>(payload),
+                endianness);
+
+            using Response = std::invoke_result_t<Function, const Request &>;
+            if constexpr (std::is_void_v<Response>)
+            {
+                function(request);
+            }
+            else
+            {
+                send(function(request));
+            }
+        };
+        command_index++;
+
+        this->log(_log, "Added command handler for %u (%s).\n", id,
+                  (help) ? help : "(unknown)");
+    }
+
+    /*
+     * Frame and encode a structure to the output buffer. If the encoded frame
+     * doesn't fit, the buffer is serviced (up to 'attempts' times) and the
+     * frame is dropped if there's still no room for it.
+     */
+    template <class Message>
+    Result send(const Message &message,
+                std::size_t attempts = default_binary_send_attempts)
+    {
+        std::array<uint8_t, header_size + Message::size> frame;
+        static constexpr std::size_t needed = encoded_size(frame.size());
+        static_assert(needed <= depth);
+
+        if (not tx.state.has_enough_space(needed))
+        {
+            tx.flush(attempts);
+
+            if (not tx.state.has_enough_space(needed))
+            {
+                this->log(nullptr,
+                          "Dropped message %u, no space for %zu bytes.\n",
+                          Message::id, needed);
+                return FAIL;
+            }
+        }
+
+        uint16_t id = Message::id;
+        if constexpr (endianness != std::endian::native)
+        {
+            id = std::byteswap(id);
+        }
+        std::memcpy(frame.data(), &id, header_size);
+
+        message.encode(
+            reinterpret_cast<typename Message::Buffer *>(&frame[header_size]),
+            endianness);
+
+        Cobs::MessageEncoder encoder(frame.data(), frame.size());
+        [[maybe_unused]] bool encoded = encoder.encode(tx);
+        assert(encoded);
+
+        return SUCCESS;
+    }
+
+    inline void poll()
+    {
+        decoder.dispatch(rx);
+    }
+
+    void process(const uint8_t *frame, std::size_t size)
+    {
+        uint16_t id = 0;
+        if (size >= header_size)
+        {
+            std::memcpy(&id, frame, header_size);
+            if constexpr (endianness != std::endian::native)
+            {
+                id = std::byteswap(id);
+            }
+        }
+
+        auto it = lower_bound(id);
+
+        if (size < header_size or it == commands.begin() + command_index or
+            it->id != id)
+        {
+            unknown++;
+            this->log(nullptr, "Command %u not found (%zu bytes).\n", id,
+                      size);
+        }
+        else if (size != header_size + it->size)
+        {
+            malformed++;
+            this->log(nullptr, "Command %u expects %zu bytes (got %zu).\n", id,
+                      it->size, size - header_size);
+        }
+        else
+        {
+            it->handler(&frame[header_size]);
+        }
+    }
+
+    void help()
+    {
+        this->log(nullptr, "%zu commands registered:\n", command_index);
+
+        for (std::size_t i = 0; i < command_index; i++)
+        {
+            auto &cmd = commands[i];
+            this->log(nullptr, "  %u (%zu bytes): %s\n", cmd.id, cmd.size,
+                      (cmd.help) ? cmd.help : "(unknown)");
+        }
+    }
+
+    void poll_metrics(uint16_t &_unknown, uint16_t &_malformed,
+                      bool reset = true)
+    {
+        _unknown = unknown;
+        _malformed = malformed;
+
+        if (reset)
+        {
+            unknown = 0;
+            malformed = 0;
+        }
+    }
+
+  protected:
+    Buffer &rx;
+    Buffer &tx;
+    Decoder decoder;
+
+    struct Command
+    {
+        uint16_t id;
+        std::size_t size;
+        Handler handler;
+        const char *help = nullptr;
+    };
+
+    /* The most space a frame of 'size' bytes can take once encoded. */
+    static constexpr std::size_t encoded_size(std::size_t size)
+    {
+        /* A zero pointer per block, plus the first one and the delimiter. */
+        return size + size / (Cobs::zero_pointer_max - 1) + 2;
+    }
+
+    /* Find the first command not ordered before 'id'. */
+    inline auto lower_bound(uint16_t id)
+    {
+        return std::lower_bound(
+            commands.begin(), commands.begin() + command_index, id,
+            [](const Command &cmd, uint16_t value) { return cmd.id < value; });
+    }
+
+    std::array<Command, max_commands> commands;
+    std::size_t command_index;
+
+    /* Metrics. */
+    uint16_t unknown;
+    uint16_t malformed;
+};
+
+} // namespace Coral
@@ -6,9 +6,13 @@
 
 /* toolchain */
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <cstdint>
-#include <cstdlib>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 /* internal */
 #include "../logging/PrintfLogger.h"
@@ -22,6 +26,7 @@ class ElementCommandLine : public HasLogInterface<T>
 {
   public:
     using String = std::basic_string<element_t>;
+    using StringView = std::basic_string_view<element_t>;
 
     ElementCommandLine(const element_t **_line, std::size_t _length,
                        LogInterface<T> *_log = nullptr)
@@ -37,27 +42,107 @@ class ElementCommandLine : public HasLogInterface<T>
     }
 
     template <std::size_t index>
-    Result as_long(long &output, LogInterface<T> *_log = nullptr)
+    inline Result as_long(long &output, LogInterface<T> *_log = nullptr)
     {
+        return as_integer<index>(output, _log);
+    }
+
+    /*
+     * Convert an argument to any integer type (with range checking). A base
+     * of zero detects a '0x' (hexadecimal) or leading '0' (octal) prefix.
+     */
+    template <std::size_t index, typename int_t>
+    Result as_integer(int_t &output, LogInterface<T> *_log = nullptr,
+                      int base = 0)
+    {
+        static_assert(std::is_integral_v<int_t>);
+
         bool result = false;
         auto elem = at<index>(_log);
 
         if (elem)
         {
-            char *endptr;
-            output = std::strtol(elem, &endptr, 0);
+            StringView value(elem);
 
-            /* Conversion succeeded if we reached the end of the string. */
-            result = *endptr == '\0';
+            bool negative = strip_sign(value);
+            base = strip_prefix(value, base);
 
-            if (not result)
+            uintmax_t magnitude;
+            result =
+                parse_digits(value, magnitude, base, index, elem, _log) and
+                fit(negative, magnitude, output, index, elem, _log);
+        }
+
+        return ToResult(result);
+    }
+
+    template <std::size_t index, typename int_t = unsigned long>
+    inline Result as_unsigned(int_t &output, LogInterface<T> *_log = nullptr)
+    {
+        static_assert(std::is_unsigned_v<int_t>);
+        return as_integer<index>(output, _log);
+    }
+
+    /* Hexadecimal (the '0x' prefix is optional). */
+    template <std::size_t index, typename int_t>
+    inline Result as_hex(int_t &output, LogInterface<T> *_log = nullptr)
+    {
+        return as_integer<index>(output, _log, 16);
+    }
+
+    /*
+     * Convert a decimal argument (e.g. '-1.25') to a fixed-point integer with
+     * 'frac_bits' fractional bits (rounded to nearest, at most
+     * 'max_fraction_digits' digits are significant).
+     */
+    template <std::size_t index, std::size_t frac_bits, typename int_t>
+    Result as_fixed(int_t &output, LogInterface<T> *_log = nullptr)
+    {
+        static_assert(std::is_integral_v<int_t>);
+        static_assert(frac_bits <= 32 and frac_bits < sizeof(int_t) * 8);
+
+        bool result = false;
+        auto elem = at<index>(_log);
+
+        if (elem)
+        {
+            StringView value(elem);
+            bool negative = strip_sign(value);
+
+            StringView fraction;
+            auto point = value.find('.');
+            if (point != StringView::npos)
+            {
+                fraction = value.substr(point + 1);
+                value = value.substr(0, point);
+            }
+
+            uintmax_t whole = 0;
+            uintmax_t scaled = 0;
+
+            /* At least one digit is required (e.g. '.5' or '1.'). */
+            if (value.empty() and fraction.empty())
             {
                 this->log(_log,
-                          "(index %zu) Couldn't convert '%s' to an integer "
-                          "(error at "
-                          "'%s').\n",
-                          index, elem, endptr);
+                          "(index %zu) Couldn't convert '%s' to a "
+                          "fixed-point value (no digits).\n",
+                          index, elem);
+                return ToResult(false);
+            }
+
+            result = (value.empty() or
+                      parse_digits(value, whole, 10, index, elem, _log)) and
+                     parse_fraction<frac_bits>(fraction, scaled, index, elem,
+                                               _log);
+
+            if (result and whole > (UINTMAX_MAX >> frac_bits) - 1)
+            {
+                log_range(index, elem, _log);
+                result = false;
             }
+
+            result = result and fit(negative, (whole << frac_bits) + scaled,
+                                    output, index, elem, _log);
         }
 
         return ToResult(result);
@@ -71,11 +156,44 @@ class ElementCommandLine : public HasLogInterface<T>
 
         if (elem)
         {
-            char *endptr;
-            output = std::strtod(elem, &endptr);
+            StringView value(elem);
+
+            /*
+             * 'from_chars' doesn't accept an explicit positive sign or a
+             * hexadecimal prefix (e.g. '-0x1p3'), so handle both here.
+             */
+            bool negative = value.starts_with('-');
+            if (negative or value.starts_with('+'))
+            {
+                value.remove_prefix(1);
+            }
+
+            auto format = std::chars_format::general;
+            if (value.starts_with("0x") or value.starts_with("0X"))
+            {
+                format = std::chars_format::hex;
+                value.remove_prefix(2);
+            }
+
+            const element_t *ptr = value.data();
+            auto ec = std::errc::invalid_argument;
+
+            /* Only one sign is allowed. */
+            if (not value.starts_with('-') and not value.starts_with('+'))
+            {
+                auto parsed = std::from_chars(
+                    value.data(), value.data() + value.size(), output, format);
+                ptr = parsed.ptr;
+                ec = parsed.ec;
+            }
 
             /* Conversion succeeded if we reached the end of the string. */
-            result = *endptr == '\0';
+            result = ec == std::errc() and ptr == value.data() + value.size();
+
+            if (result and negative)
+            {
+                output = -output;
+            }
 
             if (not result)
             {
@@ -83,7 +201,7 @@ class ElementCommandLine : public HasLogInterface<T>
                     _log,
                     "(index %zu) Couldn't convert '%s' to a double (error at "
                     "'%s').\n",
-                    index, elem, endptr);
+                    index, elem, ptr);
             }
         }
 
@@ -98,13 +216,13 @@ class ElementCommandLine : public HasLogInterface<T>
 
         if (elem)
         {
-            String value(elem);
-            if (value.compare("true") == 0)
+            StringView value(elem);
+            if (value == "true")
             {
                 output = true;
                 result = true;
             }
-            else if (value.compare("false") == 0)
+            else if (value == "false")
             {
                 output = false;
                 result = true;
@@ -121,6 +239,55 @@ class ElementCommandLine : public HasLogInterface<T>
         return ToResult(result);
     }
 
+    /* Convert an argument based on the output type. */
+    template <std::size_t index, typename value_t>
+    Result as(value_t &output, LogInterface<T> *_log = nullptr)
+    {
+        if constexpr (std::is_same_v<value_t, bool>)
+        {
+            return as_bool<index>(output, _log);
+        }
+        else if constexpr (std::is_integral_v<value_t>)
+        {
+            return as_integer<index>(output, _log);
+        }
+        else if constexpr (std::is_floating_point_v<value_t>)
+        {
+            double value;
+            bool result = ToBool(as_double<index>(value, _log));
+
+            /* Finite values must also be finite after narrowing. */
+            if (result and std::isfinite(value) and
+                std::fabs(value) > std::numeric_limits<value_t>::max())
+            {
+                log_range(index, at<index>(_log), _log);
+                result = false;
+            }
+
+            if (result)
+            {
+                output = static_cast<value_t>(value);
+            }
+            return ToResult(result);
+        }
+        else if constexpr (std::is_same_v<value_t, const element_t *>)
+        {
+            output = at<index>(_log);
+            return ToResult(output);
+        }
+        else
+        {
+            static_assert(std::is_same_v<value_t, StringView>);
+
+            auto elem = at<index>(_log);
+            if (elem)
+            {
+                output = StringView(elem);
+            }
+            return ToResult(elem);
+        }
+    }
+
     template <std::size_t index>
     const element_t *at(LogInterface<T> *_log = nullptr)
     {
@@ -141,12 +308,148 @@ class ElementCommandLine : public HasLogInterface<T>
         return result;
     }
 
-    inline const String get_command()
+    inline StringView get_command()
     {
-        return String(command);
+        return StringView(command);
     }
 
+    /* The number of arguments (not including the command). */
+    inline std::size_t size() const
+    {
+        return length;
+    }
+
+    static constexpr std::size_t max_fraction_digits = 9;
+
   protected:
+    /* Remove a leading sign, returns true if negative. */
+    static bool strip_sign(StringView &value)
+    {
+        bool negative = value.starts_with('-');
+        if (negative or value.starts_with('+'))
+        {
+            value.remove_prefix(1);
+        }
+        return negative;
+    }
+
+    /* Remove a base prefix (and resolve the base if it's zero). */
+    static int strip_prefix(StringView &value, int base)
+    {
+        bool hex_prefix = value.size() > 2 and value[0] == '0' and
+                          (value[1] == 'x' or value[1] == 'X');
+
+        if ((base == 0 or base == 16) and hex_prefix)
+        {
+            value.remove_prefix(2);
+            base = 16;
+        }
+        else if (base == 0)
+        {
+            base = (value.size() > 1 and value[0] == '0') ? 8 : 10;
+        }
+
+        return base;
+    }
+
+    void log_range(std::size_t index, const element_t *elem,
+                   LogInterface<T> *_log)
+    {
+        this->log(_log, "(index %zu) '%s' is out of range.\n", index, elem);
+    }
+
+    bool parse_digits(StringView value, uintmax_t &output, int base,
+                      std::size_t index, const element_t *elem,
+                      LogInterface<T> *_log)
+    {
+        const element_t *end = value.data() + value.size();
+        auto [ptr, ec] = std::from_chars(value.data(), end, output, base);
+
+        bool result = ec == std::errc() and ptr == end;
+        if (ec == std::errc::result_out_of_range)
+        {
+            log_range(index, elem, _log);
+        }
+        else if (not result)
+        {
+            this->log(_log,
+                      "(index %zu) Couldn't convert '%s' to an integer "
+                      "(error at '%s').\n",
+                      index, elem, ptr);
+        }
+
+        return result;
+    }
+
+    /* Scale decimal fraction digits by 2^frac_bits (rounded). */
+    template <std::size_t frac_bits>
+    bool parse_fraction(StringView value, uintmax_t &output,
+                        std::size_t index, const element_t *elem,
+                        LogInterface<T> *_log)
+    {
+        uint64_t numerator = 0;
+        uint64_t denominator = 1;
+
+        for (std::size_t i = 0; i < value.size(); i++)
+        {
+            if (value[i] < '0' or value[i] > '9')
+            {
+                this->log(_log,
+                          "(index %zu) Couldn't convert '%s' to a "
+                          "fixed-point value (error at '%s').\n",
+                          index, elem, &value[i]);
+                return false;
+            }
+
+            if (i < max_fraction_digits)
+            {
+                numerator = numerator * 10 + (value[i] - '0');
+                denominator *= 10;
+            }
+        }
+
+        output = ((numerator << frac_bits) + denominator / 2) / denominator;
+        return true;
+    }
+
+    /* Apply a sign to a magnitude if the result fits the output type. */
+    template <typename int_t>
+    bool fit(bool negative, uintmax_t magnitude, int_t &output,
+             std::size_t index, const element_t *elem, LogInterface<T> *_log)
+    {
+        using limits = std::numeric_limits<int_t>;
+
+        /* The magnitude of the minimum value (computed without overflow). */
+        uintmax_t max_negative = 0;
+        if constexpr (limits::is_signed)
+        {
+            max_negative = uintmax_t(-(limits::min() + 1)) + 1;
+        }
+
+        bool result = (negative) ? magnitude <= max_negative
+                                 : magnitude <= uintmax_t(limits::max());
+
+        if (result)
+        {
+            if (negative and magnitude)
+            {
+                /* Only reachable for signed types. */
+                output = static_cast<int_t>(
+                    -static_cast<intmax_t>(magnitude - 1) - 1);
+            }
+            else
+            {
+                output = static_cast<int_t>(magnitude);
+            }
+        }
+        else
+        {
+            log_range(index, elem, _log);
+        }
+
+        return result;
+    }
+
     const element_t **line;
     const element_t *command;
     std::size_t length;
@@ -4,8 +4,15 @@
  */
 #pragma once
 
+/* toolchain */
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
 /* internal */
+#include "../buffer/MessageBuffer.h"
 #include "CommandLine.h"
+#include "CommandSchema.h"
 #include "StringCommandProcessor.h"
 
 namespace Coral
@@ -15,69 +22,165 @@ static constexpr std::size_t default_max_line = 256;
 
 static constexpr std::size_t default_max_commands = 16;
 
+static constexpr std::size_t default_max_batch = 4;
+
 template <std::size_t max_commands = default_max_commands,
           std::size_t depth = default_max_line,
           std::size_t max_args = default_max_args, typename element_t = char,
-          class T = PrintfLogger>
+          class T = PrintfLogger, std::size_t max_batch = default_max_batch>
 class ElementCommandLineApp : public HasLogInterface<T>
 {
+    static_assert(max_batch > 0);
+
   public:
     using CommandLine = ElementCommandLine<element_t, T>;
     using Processor = StringCommandProcessor<depth, element_t, max_args>;
+    using StringView = typename CommandLine::StringView;
 
     using Handler = std::function<void(CommandLine &)>;
 
     using CommandRegistration = std::function<void(ElementCommandLineApp &)>;
 
     ElementCommandLineApp(CommandRegistration register_commands,
-                          typename Processor::Buffer &input,
+                          typename Processor::Buffer &_input,
                           LogInterface<T> *_log = nullptr)
         : HasLogInterface<T>(_log),
           processor(/* LCOV_EXCL_LINE */
-                    input,
+                    _input,
                     [this](const element_t **argv, std::size_t argc) {
-                        process(argv, argc);
+                        dispatch(argv, argc);
                     },
                     true /* auto_poll */),
-          commands(), command_index(0)
+          commands(), command_index(0), input(_input), batch_mode(false),
+          batch(), batch_line(), batch_args(), forced_batches(0)
     {
         add_handler("help", [this](CommandLine &cli) { help(cli); });
         register_commands(*this);
     }
 
     /* interface for registering a command */
-    void add_handler(const element_t *command, Handler handler,
+    inline void add_handler(const element_t *command, Handler handler,
+                            const char *help = nullptr,
+                            LogInterface<T> *_log = nullptr)
+    {
+        insert(command, handler, help, nullptr, _log);
+    }
+
+    /*
+     * Register a command with typed arguments. The number of arguments is
+     * checked and each is converted before the handler is called (with one
+     * parameter per type in 'Args'), e.g.
+     *
+     *     app.add_command<int, bool>("set", [](int a, bool b) { ... });
+     *
+     * Usage text for 'help' is generated from the argument types.
+     */
+    template <typename... Args, typename Function>
+    void add_command(const element_t *command, Function function,
                      const char *help = nullptr,
                      LogInterface<T> *_log = nullptr)
     {
-        this->log(_log, "Added command handler for '%s'.\n", command);
+        static_assert(std::is_invocable_v<Function, Args...>);
 
-        commands[command_index].command = command;
-        commands[command_index].handler = handler;
-        commands[command_index].help = help;
-        command_index++;
+        insert(
+            command,
+            [this, function](CommandLine &cli) {
+                invoke<Args...>(cli, function,
+                                std::index_sequence_for<Args...>{});
+            },
+            help, CommandSignature<Args...>::usage(), _log);
     }
 
-    void process(const element_t **argv, std::size_t argc)
+    /* See StringCommandProcessor::set_word_delims. */
+    inline Result set_word_delims(
+        StringView delims,
+        StringView quotes = Processor::Tokenizer::default_quotes)
     {
-        CommandLine cli(argv, argc, this->logger);
+        return processor.set_word_delims(delims, quotes);
+    }
 
-        bool handled = false;
+    /*
+     * In batch mode, parsed commands are queued instead of being executed
+     * immediately. Every line available in the input buffer is parsed first,
+     * then the queue is executed in order (so the input buffer doesn't back
+     * up while commands run). Commands are executed early if the queue fills
+     * up. Responses are written (in order) to this application's logger
+     * (e.g. a ViewBufferLogger with a buffer_log_handler).
+     */
+    void set_batch_mode(bool enable = true)
+    {
+        batch_mode = enable;
 
-        for (std::size_t i = 0; i < command_index; i++)
+        /* Replace the input buffer's existing callback. */
+        input.set_data_available();
+
+        if (batch_mode)
         {
-            auto &cmd = commands[i];
-            handled = cmd.handle(cli);
-            if (handled)
+            input.set_data_available([this](typename Processor::Buffer *buf) {
+                (void)buf;
+                poll();
+            });
+        }
+        else
+        {
+            execute_batch();
+            processor.set_auto_poll();
+        }
+    }
+
+    /* Parse all available input, then execute any queued commands. */
+    std::size_t poll()
+    {
+        processor.poll();
+        return execute_batch();
+    }
+
+    std::size_t execute_batch()
+    {
+        std::size_t count = 0;
+        std::size_t length;
+
+        while (ToBool(batch.get_message(batch_line.data(), length)))
+        {
+            /* Arguments were queued as consecutive, terminated strings. */
+            std::size_t argc = 0;
+            for (std::size_t i = 0; i < length; i++)
             {
-                break;
+                batch_args[argc++] = &batch_line[i];
+                i += std::char_traits<element_t>::length(&batch_line[i]);
             }
+
+            process(batch_args.data(), argc);
+            count++;
         }
 
-        if (not handled)
+        return count;
+    }
+
+    void poll_metrics(uint16_t &_forced_batches, bool reset = true)
+    {
+        _forced_batches = forced_batches;
+
+        if (reset)
         {
-            this->log(nullptr, "Command '%s' not found.\n",
-                      cli.get_command().c_str());
+            forced_batches = 0;
+        }
+    }
+
+    void process(const element_t **argv, std::size_t argc)
+    {
+        CommandLine cli(argv, argc, this->logger);
+
+        auto name = cli.get_command();
+        auto it = lower_bound(name);
+
+        if (it != commands.begin() + command_index and it->command == name)
+        {
+            it->handler(cli);
+        }
+        else
+        {
+            this->log(nullptr, "Command '%s' not found.\n", name.data());
             help(cli);
         }
     }
@@ -85,6 +188,121 @@ class ElementCommandLineApp : public HasLogInterface<T>
   protected:
     Processor processor;
 
+    void dispatch(const element_t **argv, std::size_t argc)
+    {
+        if (batch_mode)
+        {
+            enqueue(argv, argc);
+        }
+        else
+        {
+            process(argv, argc);
+        }
+    }
+
+    void enqueue(const element_t **argv, std::size_t argc)
+    {
+        std::size_t lengths[max_args];
+        std::size_t total = 0;
+
+        for (std::size_t i = 0; i < argc; i++)
+        {
+            lengths[i] = std::char_traits<element_t>::length(argv[i]) + 1;
+            total += lengths[i];
+        }
+
+        /* Tokens (and terminators) always fit in a line. */
+        assert(total <= depth);
+
+        /* Make room by executing what's queued. */
+        if (batch.full(total))
+        {
+            execute_batch();
+            forced_batches++;
+        }
+
+        std::size_t index = 0;
+        for (std::size_t i = 0; i < argc; i++)
+        {
+            std::memcpy(&batch_line[index], argv[i],
+                        lengths[i] * sizeof(element_t));
+            index += lengths[i];
+        }
+
+        bool result = ToBool(batch.put_message(batch_line.data(), total));
+        assert(result);
+        (void)result;
+    }
+
+    void insert(const element_t *command, Handler handler, const char *help,
+                const char *usage, LogInterface<T> *_log)
+    {
+        if (command_index >= max_commands)
+        {
+            this->log(_log,
+                      "Can't add command '%s', all %zu slots are in use.\n",
+                      command, max_commands);
+            return;
+        }
+
+        StringView name(command);
+
+        /*
+         * Keep commands sorted by name (so they can be found with a binary
+         * search) by inserting in place.
+         */
+        auto end = commands.begin() + command_index;
+        auto it = lower_bound(name);
+
+        if (it != end and it->command == name)
+        {
+            this->log(_log, "Command '%s' already registered.\n", command);
+            return;
+        }
+
+        std::move_backward(it, end, end + 1);
+        it->command = name;
+        it->handler = handler;
+        it->help = help;
+        it->usage = usage;
+        command_index++;
+
+        this->log(_log, "Added command handler for '%s'.\n", command);
+    }
+
+    /* Validate and convert all arguments, then call the handler. */
+    template <typename... Args, typename Function, std::size_t... indices>
+    void invoke(CommandLine &cli, const Function &function,
+                std::index_sequence<indices...>)
+    {
+        if (cli.size() != sizeof...(Args))
+        {
+            this->log(nullptr, "'%s' takes %zu arguments (got %zu).\n",
+                      cli.get_command().data(), sizeof...(Args), cli.size());
+            log_usage<Args...>(cli);
+            return;
+        }
+
+        std::tuple<std::remove_cvref_t<Args>...> values;
+
+        if ((ToBool(cli.template as<indices>(std::get<indices>(values))) and
+             ...))
+        {
+            function(std::get<indices>(values)...);
+        }
+        else
+        {
+            log_usage<Args...>(cli);
+        }
+    }
+
+    template <typename... Args> void log_usage(CommandLine &cli)
+    {
+        this->log(nullptr, "usage: %s%s%s\n", cli.get_command().data(),
+                  (sizeof...(Args)) ? " " : "",
+                  CommandSignature<Args...>::usage());
+    }
+
     void help(CommandLine &cli)
     {
         (void)cli;
@@ -94,33 +312,41 @@ class ElementCommandLineApp : public HasLogInterface<T>
         for (std::size_t i = 0; i < command_index; i++)
         {
             auto &cmd = commands[i];
-            this->log(nullptr, "  %s: %s\n", cmd.command,
+            this->log(nullptr, "  %s%s%s: %s\n", cmd.command.data(),
+                      (cmd.usage and *cmd.usage) ? " " : "",
+                      (cmd.usage) ? cmd.usage : "",
                       (cmd.help) ? cmd.help : "(unknown)");
         }
     }
 
     struct Command
     {
-        const element_t *command;
+        StringView command;
         Handler handler;
         const char *help = nullptr;
-
-        bool handle(CommandLine &cli)
-        {
-            bool should_handle =
-                strcmp(command, cli.get_command().c_str()) == 0;
-
-            if (should_handle)
-            {
-                handler(cli);
-            }
-
-            return should_handle;
-        }
+        const char *usage = nullptr;
     };
 
+    /* Find the first command not ordered before 'name'. */
+    inline auto lower_bound(StringView name)
+    {
+        return std::lower_bound(
+            commands.begin(), commands.begin() + command_index, name,
+            [](const Command &cmd, StringView value) {
+                return cmd.command < value;
+            });
+    }
+
     std::array<Command, max_commands> commands;
     std::size_t command_index;
+
+    /* Batch mode. */
+    typename Processor::Buffer &input;
+    bool batch_mode;
+    MessageBuffer<depth * max_batch, max_batch, element_t> batch;
+    std::array<element_t, depth> batch_line;
+    std::array<const element_t *, max_args> batch_args;
+    uint16_t forced_batches;
 };
 
 using CommandLineApp = ElementCommandLineApp<>;
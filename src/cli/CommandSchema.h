@@ -0,0 +1,84 @@
+/**
+ * \file
+ * \brief Compile-time descriptions of typed command arguments.
+ */
+#pragma once
+
+/* toolchain */
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace Coral
+{
+
+/* The name used for an argument type in usage text. */
+template <typename value_t> consteval std::string_view argument_name()
+{
+    using type = std::remove_cvref_t<value_t>;
+
+    if constexpr (std::is_same_v<type, bool>)
+    {
+        return "bool";
+    }
+    else if constexpr (std::is_integral_v<type> and std::is_signed_v<type>)
+    {
+        return "int";
+    }
+    else if constexpr (std::is_integral_v<type>)
+    {
+        return "uint";
+    }
+    else if constexpr (std::is_floating_point_v<type>)
+    {
+        return "float";
+    }
+    else
+    {
+        return "string";
+    }
+}
+
+/*
+ * Usage text for a list of argument types (e.g. '<int> <bool>'), generated
+ * at compile time.
+ */
+template <typename... Args> struct CommandSignature
+{
+    /* Each argument is '<name>' and all but the first are preceded by ' '. */
+    static constexpr std::size_t length =
+        ((argument_name<Args>().size() + 3) + ... + 0);
+
+    static constexpr std::array<char, length + 1> make()
+    {
+        std::array<char, length + 1> result = {};
+        std::size_t index = 0;
+
+        auto append = [&result, &index](std::string_view name) {
+            if (index)
+            {
+                result[index++] = ' ';
+            }
+            result[index++] = '<';
+            for (auto elem : name)
+            {
+                result[index++] = elem;
+            }
+            result[index++] = '>';
+        };
+        (append(argument_name<Args>()), ...);
+        (void)append;
+
+        return result;
+    }
+
+    static constexpr auto value = make();
+
+    static constexpr const char *usage()
+    {
+        return value.data();
+    }
+};
+
+} // namespace Coral
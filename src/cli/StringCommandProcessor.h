@@ -4,8 +4,12 @@
  */
 #pragma once
 
+/* toolchain */
+#include <string>
+
 /* internal */
 #include "../buffer/PcBuffer.h"
+#include "Tokenizer.h"
 
 namespace Coral
 {
@@ -16,11 +20,15 @@ template <std::size_t depth, typename element_t = char,
           std::size_t max_args = default_max_args>
 class StringCommandProcessor
 {
+    static_assert(depth > 1);
+
   public:
     using Buffer = PcBuffer<depth, element_t>;
     using String = std::basic_string<element_t>;
 
     using Handler = std::function<void(const element_t **, std::size_t)>;
+    using Tokenizer = Coral::Tokenizer<element_t>;
+    using StringView = typename Tokenizer::StringView;
 
     static constexpr element_t null = '\0';
     static constexpr element_t default_line_delim = '\n';
@@ -31,8 +39,13 @@ class StringCommandProcessor
                            element_t _line_delim = default_line_delim,
                            element_t _word_delim = default_word_delim)
         : input(_input), handler(_handler), line_delim(_line_delim),
-          word_delim(_word_delim)
+          tokenizer(), overflows(0)
     {
+        if (_word_delim != default_word_delim)
+        {
+            set_word_delims(StringView(&_word_delim, 1));
+        }
+
         reset();
 
         if (auto_poll)
@@ -55,9 +68,20 @@ class StringCommandProcessor
         handler = _handler;
     }
 
+    /*
+     * Split words on any of 'delims' (instead of the single word delimiter)
+     * and optionally join quoted sections, e.g. with
+     * 'Tokenizer::whitespace_delims' and 'Tokenizer::shell_quotes'.
+     */
+    Result set_word_delims(StringView delims,
+                           StringView quotes = Tokenizer::default_quotes)
+    {
+        return tokenizer.configure(delims, quotes);
+    }
+
     void reset()
     {
-        std::memset(line, 0, depth);
+        /* Lines are terminated when processed, no need to clear. */
         index = 0;
     }
 
@@ -67,24 +91,20 @@ class StringCommandProcessor
 
         while (not input.empty())
         {
-            input.pop_n(&line[index], 1);
+            /* Scan the contiguous readable region for the delimiter. */
+            auto region = input.read_region();
+            auto delim = std::char_traits<element_t>::find(
+                region.data(), region.size(), line_delim);
 
-            if (line[index] != line_delim)
-            {
-                index++;
-
-                /*
-                 * Drop the current buffer if it becomes full before we see
-                 * the delimeter.
-                 */
-                if (index >= depth - 1)
-                {
-                    reset();
-                }
-            }
+            std::size_t length = (delim) ? delim - region.data()
+                                         : region.size();
+            append(region.data(), length);
+
+            /* Consume the scanned elements (and the delimiter). */
+            input.pop_n(nullptr, (delim) ? length + 1 : length);
 
             /* Only take action if we have some input. */
-            else if (index)
+            if (delim and index)
             {
                 line[index] = null;
                 process(line, index);
@@ -108,34 +128,14 @@ class StringCommandProcessor
 
     void process(element_t *line, std::size_t length)
     {
-        num_args = 0;
-        std::size_t token_start = 0;
-        std::size_t token_len = 0;
+        bool overflow;
+        num_args = tokenizer.tokenize(line, length, args, max_args, overflow);
 
-        for (std::size_t i = 0; i < length; i++)
+        /* Don't run commands with missing arguments. */
+        if (overflow)
         {
-            if (line[i] == word_delim)
-            {
-                line[i] = null;
-
-                if (token_len)
-                {
-                    args[num_args++] = &line[token_start];
-                    token_len = 0;
-                }
-
-                token_start = i + 1;
-            }
-            else
-            {
-                token_len++;
-            }
-        }
-
-        if (token_len)
-        {
-            args[num_args] = &line[token_start];
-            num_args++;
+            overflows++;
+            return;
         }
 
         /* Handle the command. */
@@ -145,19 +145,54 @@ class StringCommandProcessor
         }
     }
 
+    void poll_metrics(uint16_t &_overflows, bool reset = true)
+    {
+        _overflows = overflows;
+
+        if (reset)
+        {
+            overflows = 0;
+        }
+    }
+
   protected:
     Buffer &input;
     Handler handler;
 
+    void append(const element_t *data, std::size_t length)
+    {
+        while (length)
+        {
+            std::size_t chunk = std::min(length, depth - 1 - index);
+            std::memcpy(&line[index], data, chunk * sizeof(element_t));
+
+            index += chunk;
+            data += chunk;
+            length -= chunk;
+
+            /*
+             * Drop the current buffer if it becomes full before we see the
+             * delimeter.
+             */
+            if (index >= depth - 1)
+            {
+                reset();
+            }
+        }
+    }
+
     /* Line parsing. */
     element_t line_delim;
     element_t line[depth];
     std::size_t index;
 
     /* Word parsing. */
-    element_t word_delim;
+    Tokenizer tokenizer;
     const element_t *args[max_args];
     std::size_t num_args;
+
+    /* Lines dropped for having more than 'max_args' arguments. */
+    uint16_t overflows;
 };
 
 } // namespace Coral
@@ -7,6 +7,7 @@
 #include "../io/file_descriptors.h"
 #include "../logging/macros.h"
 #include "Termios.h"
+#include "termios2.h"
 #include "termios_util.h"
 
 namespace Coral
@@ -37,36 +38,148 @@ Result Termios::set_canonical(bool state, int optional_actions)
     return setattrs(optional_actions);
 }
 
+Result Termios::set_flow_control(bool state, int optional_actions)
+{
+    current.c_cflag =
+        (state) ? current.c_cflag | CRTSCTS : current.c_cflag & ~(CRTSCTS);
+    return setattrs(optional_actions);
+}
+
+Result Termios::set_read_timing(uint8_t vmin, uint8_t vtime,
+                                int optional_actions)
+{
+    current.c_cc[VMIN] = vmin;
+    current.c_cc[VTIME] = vtime;
+    return setattrs(optional_actions);
+}
+
 Result Termios::set_baud(long baud)
 {
     speed_t speed;
 
-    /* Could be upgraded to handle setting a non-standard baud rate (requires
-     * termios2?). */
-    auto result = ToBool(baud_to_speed(baud, speed));
+    auto result = baud > 0 and baud <= UINT32_MAX;
+
+    if (result and ToBool(baud_to_speed(baud, speed)))
+    {
+        custom_baud = 0;
+        result = cfsetspeed(&current, speed) == 0 and ToBool(setattrs());
+    }
 
-    if (result)
+    /* Rates without a 'B' constant require termios2. */
+    else if (result)
     {
-        result = cfsetspeed(&current, speed) == 0;
-        LogErrnoIfNot(setattrs());
+        custom_baud = baud;
+        result = ToBool(setattrs());
     }
 
+    LogErrnoIfNot(result);
+
     return ToResult(result);
 }
 
+Result Termios::get_baud(uint32_t &input, uint32_t &output)
+{
+    return Coral::get_baud(fd, input, output);
+}
+
+Result Termios::set_low_latency(uint8_t vmin, uint8_t vtime,
+                                bool flow_control)
+{
+    cfmakeraw(&current);
+
+    current.c_cflag |= CLOCAL | CREAD;
+    current.c_cflag = (flow_control) ? current.c_cflag | CRTSCTS
+                                     : current.c_cflag & ~(CRTSCTS);
+
+    current.c_cc[VMIN] = vmin;
+    current.c_cc[VTIME] = vtime;
+
+    auto result = setattrs();
+
+    /* Only some serial drivers support this (not an error otherwise). */
+    bool original_flag;
+    if (ToBool(result) and not serial_changed and
+        ToBool(get_serial_low_latency(fd, original_flag)) and
+        ToBool(set_serial_low_latency(fd)))
+    {
+        serial_changed = true;
+        serial_low_latency = original_flag;
+    }
+
+    return result;
+}
+
 Result Termios::setattrs(int optional_actions)
+{
+    return (transactions) ? ToResult(valid) : apply(optional_actions);
+}
+
+void Termios::begin()
+{
+    assert(transactions < UINT8_MAX);
+    transactions++;
+}
+
+Result Termios::commit(int optional_actions)
+{
+    assert(transactions);
+    transactions--;
+
+    return setattrs(optional_actions);
+}
+
+Result Termios::apply(int optional_actions)
 {
     if (valid)
     {
+        /* Nothing to do if the settings haven't changed. */
+        if (same_settings(current, applied) and custom_baud == applied_baud)
+        {
+            skipped_count++;
+            return SUCCESS;
+        }
+
         valid = tcsetattr(fd, optional_actions, &current) == 0;
+
+        /*
+         * Setting attributes also sets the (standard) speed from 'current',
+         * so a custom baud rate needs to be set again.
+         */
+        if (valid and custom_baud)
+        {
+            valid = ToBool(set_custom_baud(fd, custom_baud));
+        }
+
+        if (valid)
+        {
+            applied = current;
+            applied_baud = custom_baud;
+            applied_count++;
+        }
+
         LogErrnoIfNot(valid);
     }
 
     return ToResult(valid);
 }
 
+void Termios::poll_metrics(uint16_t &_applied, uint16_t &_skipped,
+                           bool reset)
+{
+    _applied = applied_count;
+    _skipped = skipped_count;
+
+    if (reset)
+    {
+        applied_count = 0;
+        skipped_count = 0;
+    }
+}
+
 Termios::Termios(int _fd, bool _auto_close)
-    : fd(_fd), valid(true), auto_close(_auto_close)
+    : fd(_fd), valid(true), auto_close(_auto_close), custom_baud(0),
+      applied_baud(0), transactions(0), serial_changed(false),
+      serial_low_latency(false), applied_count(0), skipped_count(0)
 {
     assert(isatty(_fd));
 
@@ -76,15 +189,24 @@ Termios::Termios(int _fd, bool _auto_close)
     valid = tcgetattr(fd, &original) == 0;
     LogErrnoIfNot(valid);
     current = original;
+    applied = original;
 }
 
 Termios::~Termios()
 {
     /*
-     * Restore the original termios structure.
+     * Restore the original termios structure (if it was changed).
      */
-    valid = tcsetattr(fd, default_action, &original) == 0;
-    LogErrnoIfNot(valid);
+    if (not same_settings(applied, original) or applied_baud)
+    {
+        valid = tcsetattr(fd, default_action, &original) == 0;
+        LogErrnoIfNot(valid);
+    }
+
+    if (serial_changed)
+    {
+        LogErrnoIfNot(set_serial_low_latency(fd, serial_low_latency));
+    }
 
     if (auto_close)
     {
@@ -104,21 +226,27 @@ static void clean_up(void)
     }
 }
 
-Termios *initialize_terminal(int fd)
+Termios *initialize_terminal(int fd, uint8_t vmin, uint8_t vtime)
 {
     if (isatty(fd) and not term)
     {
         term = new Termios(fd);
 
+        /* Apply all settings at once. */
+        term->begin();
+
         /* Turn input echo and canonical mode off. */
-        LogErrnoIfNot(term->set_echo(false));
-        LogErrnoIfNot(term->set_canonical(false));
+        term->set_echo(false);
+        term->set_canonical(false);
 
-        /* What do these settings do? */
-        term->current.c_cc[VTIME] = 0;
-        term->current.c_cc[VMIN] = 1;
+        /*
+         * Reads return once 'vmin' bytes are available, or 'vtime' tenths of
+         * a second after the last byte received.
+         */
+        term->set_read_timing(vmin, vtime);
 
-        LogErrnoIfNot(term->setattrs());
+        /* Keep any input that arrived before the terminal was set up. */
+        LogErrnoIfNot(term->commit());
 
         /* Handle signals / clean up. */
         std::atexit(clean_up);
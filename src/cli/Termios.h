@@ -8,6 +8,7 @@
 #include <termios.h>
 
 /* toolchain */
+#include <cstdint>
 #include <iostream>
 
 /* internal */
@@ -21,6 +22,13 @@ class Termios
   public:
     static constexpr int default_action = TCSAFLUSH;
 
+    /* Wait for pending output, but keep unread input. */
+    static constexpr int commit_action = TCSADRAIN;
+
+    /* Reads block until at least one byte is available. */
+    static constexpr uint8_t default_vmin = 1;
+    static constexpr uint8_t default_vtime = 0;
+
     Termios(int _fd, bool _auto_close = true);
     ~Termios();
 
@@ -30,19 +38,84 @@ class Termios
 
     Result set_echo(bool state, int optional_actions = default_action);
     Result set_canonical(bool state, int optional_actions = default_action);
+    Result set_flow_control(bool state, int optional_actions = default_action);
+
+    /*
+     * Set the minimum number of bytes for a non-canonical read (VMIN) and
+     * the inter-byte timeout in tenths of a second (VTIME).
+     */
+    Result set_read_timing(uint8_t vmin, uint8_t vtime,
+                           int optional_actions = default_action);
+
+    /*
+     * Any baud rate is supported (rates without a 'B' constant are set with
+     * termios2 and re-applied every time attributes are set).
+     */
     Result set_baud(long baud);
+    Result get_baud(uint32_t &input, uint32_t &output);
+
+    /*
+     * Configure for low-latency binary transfers: raw mode, the given read
+     * timing, optional RTS/CTS flow control and (for serial drivers that
+     * support it) 'ASYNC_LOW_LATENCY'.
+     *
+     * The default (VMIN=0, VTIME=0) makes reads return whatever is buffered
+     * without blocking, for use with poll(2). For fewer, larger reads, set
+     * VMIN to a batch size and VTIME to the idle time that ends a batch.
+     *
+     * Only enable flow control when RTS and CTS are wired (otherwise
+     * transmission stalls). The serial driver's flag is restored along with
+     * the other settings.
+     */
+    Result set_low_latency(uint8_t vmin = 0, uint8_t vtime = 0,
+                           bool flow_control = false);
 
     const int fd;
 
     struct termios current;
+
+    /*
+     * Apply 'current' (skipped if it matches what was last applied). While a
+     * transaction is open, changes are only staged.
+     */
     Result setattrs(int optional_actions = default_action);
 
+    /*
+     * Stage changes from any number of setters, then apply them all with
+     * one call to 'commit' (transactions may be nested).
+     */
+    void begin();
+    Result commit(int optional_actions = commit_action);
+
+    void poll_metrics(uint16_t &_applied, uint16_t &_skipped,
+                      bool reset = true);
+
   protected:
     struct termios original;
     bool valid;
     bool auto_close;
+
+    /* A non-standard baud rate (or zero). */
+    uint32_t custom_baud;
+
+    /* The last settings applied to the terminal. */
+    struct termios applied;
+    uint32_t applied_baud;
+
+    uint8_t transactions;
+
+    /* The serial driver's original low-latency flag (if it was changed). */
+    bool serial_changed;
+    bool serial_low_latency;
+
+    Result apply(int optional_actions);
+
+    /* Metrics. */
+    uint16_t applied_count;
+    uint16_t skipped_count;
 };
 
-Termios *initialize_terminal(int fd);
+Termios *initialize_terminal(int fd, uint8_t vmin = Termios::default_vmin,
+                             uint8_t vtime = Termios::default_vtime);
 
 } // namespace Coral
@@ -0,0 +1,476 @@
+/**
+ * \file
+ * \brief An in-place command-line tokenizer.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/* internal */
+#include "../result.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t max_token_specials = 8;
+
+/**
+ * Splits a line into tokens in place. Tokens are separated by any number of
+ * delimiter elements (spaces by default). If quote elements are configured,
+ * quoted sections (which may contain delimiters) are joined into the
+ * surrounding token with the quotes removed, and an unterminated quote
+ * extends to the end of the line.
+ *
+ * For single-byte elements, runs of ordinary elements are skipped a block at
+ * a time (each block is compared against every delimiter and quote at once)
+ * and remaining elements are classified with a lookup table. The first few
+ * elements of a token are classified individually, since short tokens end
+ * before loading a block pays off.
+ *
+ * \tparam element_t The kind of element lines consist of.
+ */
+template <typename element_t = char> class Tokenizer
+{
+  public:
+    using StringView = std::basic_string_view<element_t>;
+
+    static constexpr element_t null = '\0';
+    static constexpr element_t default_delims[] = {' ', null};
+    static constexpr element_t default_quotes[] = {null};
+
+    /* Opt-in sets (e.g. for interactive input). */
+    static constexpr element_t whitespace_delims[] = {' ', '\t', '\r', null};
+    static constexpr element_t shell_quotes[] = {'"', '\'', null};
+
+    enum Class : uint8_t
+    {
+        ordinary,
+        delimiter,
+        quote,
+    };
+
+    Tokenizer(StringView delims = default_delims,
+              StringView quotes = default_quotes)
+        : classes(), specials(), special_classes(), num_specials(0),
+          num_quotes(0), splats()
+    {
+        configure(delims, quotes);
+    }
+
+    /*
+     * Set the delimiter and quote elements. Fails (keeping only the first
+     * 'max_token_specials' elements) if there are too many.
+     */
+    Result configure(StringView delims, StringView quotes = default_quotes)
+    {
+        classes.fill(ordinary);
+        num_specials = 0;
+        num_quotes = 0;
+
+        bool result = true;
+
+        for (auto elem : delims)
+        {
+            result &= ToBool(add(elem, delimiter));
+        }
+        for (auto elem : quotes)
+        {
+            result &= ToBool(add(elem, quote));
+        }
+
+        /*
+         * Unused comparison vectors repeat the first special element so that
+         * block scanning always performs the same (unrolled) comparisons
+         * (with no special elements, blocks are never scanned).
+         */
+        for (std::size_t i = 0; i < max_token_specials; i++)
+        {
+            auto elem = (i < num_specials) ? specials[i] : specials[0];
+            for (std::size_t j = 0; j < block_size; j++)
+            {
+                splats[i][j] = static_cast<signed char>(elem);
+            }
+        }
+
+        return ToResult(result);
+    }
+
+    inline Class classify(element_t elem) const
+    {
+        if constexpr (use_table)
+        {
+            return static_cast<Class>(classes[static_cast<uint8_t>(elem)]);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < num_specials; i++)
+            {
+                if (specials[i] == elem)
+                {
+                    return special_classes[i];
+                }
+            }
+            return ordinary;
+        }
+    }
+
+    /**
+     * Tokenize a line in place (tokens are null terminated).
+     *
+     * \param[in,out] line     The line to tokenize. Must have storage for a
+     *                         terminator at \p length.
+     * \param[in]     length   The number of elements in \p line.
+     * \param[out]    args     Array to write token pointers to.
+     * \param[in]     max_args The size of \p args.
+     * \param[out]    overflow Set if the line has more than \p max_args
+     *                         tokens (only \p max_args are written).
+     * \return                 The number of tokens written to \p args.
+     */
+    std::size_t tokenize(element_t *line, std::size_t length,
+                         const element_t **args, std::size_t max_args,
+                         bool &overflow) const
+    {
+        /* Without quotes, tokens never need to be compacted. */
+        if (not num_quotes)
+        {
+            return split(line, length, args, max_args, overflow);
+        }
+
+        std::size_t count = 0;
+        std::size_t i = 0;
+
+        Scanner scanner(*this, line, length);
+
+        overflow = false;
+
+        while (true)
+        {
+            /* Skip delimiters. */
+            while (i < length and classify(line[i]) == delimiter)
+            {
+                i++;
+            }
+
+            if (i >= length)
+            {
+                break;
+            }
+
+            if (count >= max_args)
+            {
+                overflow = true;
+                break;
+            }
+
+            /* Tokens are compacted in place (quotes are removed). */
+            std::size_t out = i;
+            args[count++] = &line[out];
+
+            while (i < length)
+            {
+                std::size_t end = scanner.next(i);
+                move(line, out, i, end);
+
+                if (i >= length or classify(line[i]) == delimiter)
+                {
+                    break;
+                }
+
+                /* Quoted section. */
+                element_t closing = line[i++];
+                auto found = std::char_traits<element_t>::find(
+                    &line[i], length - i, closing);
+
+                end = (found) ? found - line : length;
+                move(line, out, i, end);
+
+                if (found)
+                {
+                    i++;
+                }
+            }
+
+            /* Terminate the token and advance past its delimiter. */
+            line[out] = null;
+            i++;
+        }
+
+        return count;
+    }
+
+  protected:
+    static constexpr bool use_table = sizeof(element_t) == 1;
+
+    std::array<uint8_t, (use_table) ? 256 : 1> classes;
+
+    std::array<element_t, max_token_specials> specials;
+    std::array<Class, max_token_specials> special_classes;
+    std::size_t num_specials;
+    std::size_t num_quotes;
+
+    static constexpr std::size_t block_size = 16;
+
+    /* Elements checked individually before scanning a block. */
+    static constexpr std::size_t scalar_scan = 8;
+    using Block = signed char __attribute__((vector_size(block_size)));
+
+    std::array<Block, max_token_specials> splats;
+
+    Result add(element_t elem, Class kind)
+    {
+        if (num_specials >= max_token_specials)
+        {
+            return FAIL;
+        }
+
+        specials[num_specials] = elem;
+        special_classes[num_specials] = kind;
+        num_specials++;
+
+        if constexpr (use_table)
+        {
+            classes[static_cast<uint8_t>(elem)] = kind;
+        }
+
+        if (kind == quote)
+        {
+            num_quotes++;
+        }
+
+        return SUCCESS;
+    }
+
+    /* Tokenize a line that only has delimiters (tokens stay in place). */
+    std::size_t split(element_t *line, std::size_t length,
+                      const element_t **args, std::size_t max_args,
+                      bool &overflow) const
+    {
+        std::size_t count = 0;
+
+        Scanner scanner(*this, line, length);
+
+        overflow = false;
+
+        for (std::size_t i = 0; i < length; i++)
+        {
+            if (classify(line[i]) == delimiter)
+            {
+                continue;
+            }
+
+            if (count >= max_args)
+            {
+                overflow = true;
+                break;
+            }
+
+            std::size_t start = i;
+            args[count++] = &line[start];
+
+            if (scanner.classified(i))
+            {
+                i = scanner.next(i);
+            }
+            else
+            {
+                /* Short tokens end before a block scan pays off. */
+                for (i++; i < length and classify(line[i]) == ordinary; i++)
+                {
+                    if (i - start >= scalar_scan)
+                    {
+                        i = scanner.next(i, false);
+                        break;
+                    }
+                }
+            }
+
+            /* Terminate the token (its end is a delimiter or 'length'). */
+            line[i] = null;
+        }
+
+        return count;
+    }
+
+    /* Move elements [start, end) to 'out' and advance both cursors. */
+    static inline void move(element_t *line, std::size_t &out,
+                            std::size_t &start, std::size_t end)
+    {
+        std::size_t count = end - start;
+
+        if (out != start)
+        {
+            std::memmove(&line[out], &line[start], count * sizeof(element_t));
+        }
+
+        out += count;
+        start = end;
+    }
+
+    /*
+     * Finds delimiters and quotes. For single-byte elements, the
+     * classification of the most recent block is kept so that short tokens
+     * within one block only scan it once.
+     */
+    class Scanner
+    {
+      public:
+        Scanner(const Tokenizer &_tokenizer, const element_t *_line,
+                std::size_t _length)
+            : tokenizer(_tokenizer), line(_line), length(_length),
+              base(_length), lanes()
+        {
+        }
+
+        /* Whether the block holding 'i' is already classified. */
+        inline bool classified(std::size_t i) const
+        {
+            return i >= base and i < base + block_size;
+        }
+
+        /*
+         * Find the index of the next delimiter or quote (or 'length').
+         * 'scalar' is cleared if the first few elements were already checked.
+         */
+        std::size_t next(std::size_t i, bool scalar = true)
+        {
+            if (not tokenizer.num_specials)
+            {
+                return length;
+            }
+
+            if constexpr (use_table)
+            {
+                if (length >= block_size)
+                {
+                    /*
+                     * Unless the block holding 'i' is already classified,
+                     * check the first few elements individually.
+                     */
+                    if (scalar and not classified(i))
+                    {
+                        std::size_t limit = std::min(length, i + scalar_scan);
+                        while (i < limit and
+                               tokenizer.classify(line[i]) == ordinary)
+                        {
+                            i++;
+                        }
+                        if (i < limit or i >= length)
+                        {
+                            return i;
+                        }
+                    }
+
+                    return next_block(i);
+                }
+            }
+
+            while (i < length and tokenizer.classify(line[i]) == ordinary)
+            {
+                i++;
+            }
+            return i;
+        }
+
+      protected:
+        const Tokenizer &tokenizer;
+        const element_t *line;
+        std::size_t length;
+
+        std::size_t base;
+        uint64_t lanes[2];
+
+        void load(std::size_t index)
+        {
+            /* The last block overlaps the previous one (if necessary). */
+            base = std::min(index, length - block_size);
+
+            Block block;
+            std::memcpy(&block, &line[base], block_size);
+
+            Block mask = {};
+#pragma GCC unroll 8
+            for (std::size_t j = 0; j < max_token_specials; j++)
+            {
+                mask |= block == tokenizer.splats[j];
+            }
+
+            std::memcpy(lanes, &mask, block_size);
+        }
+
+        /* Select bytes at or after 'offset' within a lane. */
+        static inline uint64_t after(uint64_t lane, std::size_t offset)
+        {
+            if (offset >= 8)
+            {
+                return 0;
+            }
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                return lane & (~uint64_t(0) << (offset * 8));
+            }
+            else
+            {
+                return lane & (~uint64_t(0) >> (offset * 8));
+            }
+        }
+
+        static inline std::size_t first_set_byte(uint64_t lane)
+        {
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                return std::countr_zero(lane) / 8;
+            }
+            else
+            {
+                return std::countl_zero(lane) / 8;
+            }
+        }
+
+        std::size_t next_block(std::size_t i)
+        {
+            if (i >= length)
+            {
+                return length;
+            }
+
+            if (i < base or i >= base + block_size)
+            {
+                load(i);
+            }
+
+            while (true)
+            {
+                std::size_t offset = i - base;
+
+                uint64_t lane = after(lanes[0], offset);
+                if (lane)
+                {
+                    return base + first_set_byte(lane);
+                }
+
+                lane = (offset >= 8) ? after(lanes[1], offset - 8)
+                                     : lanes[1];
+                if (lane)
+                {
+                    return base + 8 + first_set_byte(lane);
+                }
+
+                i = base + block_size;
+                if (i >= length)
+                {
+                    return length;
+                }
+                load(i);
+            }
+        }
+    };
+};
+
+} // namespace Coral
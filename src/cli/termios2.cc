@@ -0,0 +1,76 @@
+/* linux */
+#include <asm/termbits.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+
+/* internal */
+#include "termios2.h"
+
+namespace Coral
+{
+
+Result set_custom_baud(int fd, uint32_t baud)
+{
+    struct termios2 data;
+
+    bool result = ioctl(fd, TCGETS2, &data) == 0;
+
+    if (result)
+    {
+        data.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+        data.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+        data.c_ispeed = baud;
+        data.c_ospeed = baud;
+
+        result = ioctl(fd, TCSETS2, &data) == 0;
+    }
+
+    return ToResult(result);
+}
+
+Result get_baud(int fd, uint32_t &input, uint32_t &output)
+{
+    struct termios2 data;
+
+    bool result = ioctl(fd, TCGETS2, &data) == 0;
+
+    if (result)
+    {
+        input = data.c_ispeed;
+        output = data.c_ospeed;
+    }
+
+    return ToResult(result);
+}
+
+Result set_serial_low_latency(int fd, bool enable)
+{
+    struct serial_struct data;
+
+    bool result = ioctl(fd, TIOCGSERIAL, &data) == 0;
+
+    if (result)
+    {
+        data.flags = (enable) ? data.flags | ASYNC_LOW_LATENCY
+                              : data.flags & ~ASYNC_LOW_LATENCY;
+        result = ioctl(fd, TIOCSSERIAL, &data) == 0;
+    }
+
+    return ToResult(result);
+}
+
+Result get_serial_low_latency(int fd, bool &enabled)
+{
+    struct serial_struct data;
+
+    bool result = ioctl(fd, TIOCGSERIAL, &data) == 0;
+
+    if (result)
+    {
+        enabled = data.flags & ASYNC_LOW_LATENCY;
+    }
+
+    return ToResult(result);
+}
+
+} // namespace Coral
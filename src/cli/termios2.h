@@ -0,0 +1,36 @@
+/**
+ * \file
+ * \brief Linux 'termios2' (arbitrary baud rate) and serial-driver utilities.
+ */
+#pragma once
+
+/* toolchain */
+#include <cstdint>
+
+/* internal */
+#include "../result.h"
+
+/*
+ * Note that <asm/termbits.h> (required for 'struct termios2') conflicts with
+ * <termios.h>, so only plain types are used in these interfaces.
+ */
+
+namespace Coral
+{
+
+/* Set input and output baud rates to any value (with 'BOTHER'). */
+Result set_custom_baud(int fd, uint32_t baud);
+
+/* Read back the actual input and output baud rates. */
+Result get_baud(int fd, uint32_t &input, uint32_t &output);
+
+/*
+ * Set or clear the serial driver's 'ASYNC_LOW_LATENCY' flag (fails for
+ * devices that aren't serial ports).
+ */
+Result set_serial_low_latency(int fd, bool enable = true);
+
+/* Get the serial driver's 'ASYNC_LOW_LATENCY' flag. */
+Result get_serial_low_latency(int fd, bool &enabled);
+
+} // namespace Coral
@@ -1,4 +1,5 @@
 /* toolchain */
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <vector>
@@ -204,6 +205,17 @@ void dump_term_all(std::ostream &stream, int fd, const struct termios &data)
            << std::endl;
 }
 
+bool same_settings(const struct termios &lhs, const struct termios &rhs)
+{
+    return lhs.c_iflag == rhs.c_iflag and lhs.c_oflag == rhs.c_oflag and
+           lhs.c_cflag == rhs.c_cflag and lhs.c_lflag == rhs.c_lflag and
+           lhs.c_line == rhs.c_line and
+           std::equal(std::begin(lhs.c_cc), std::end(lhs.c_cc),
+                      std::begin(rhs.c_cc)) and
+           cfgetispeed(&lhs) == cfgetispeed(&rhs) and
+           cfgetospeed(&lhs) == cfgetospeed(&rhs);
+}
+
 const char *speed_str(speed_t data)
 {
     switch (data)
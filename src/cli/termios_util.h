@@ -24,6 +24,12 @@ void dump_local_modes(std::ostream &stream, const struct termios &data);
 void dump_specials(std::ostream &stream, const struct termios &data);
 void dump_term_all(std::ostream &stream, int fd, const struct termios &data);
 
+/*
+ * Compare the settings in two structures field by field (whole-structure
+ * comparisons also compare padding and unused fields).
+ */
+bool same_settings(const struct termios &lhs, const struct termios &rhs);
+
 const char *speed_str(speed_t data);
 Result baud_to_speed(uint32_t baud, speed_t &output);
 
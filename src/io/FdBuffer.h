@@ -0,0 +1,109 @@
+/**
+ * \file
+ * \brief A full-duplex buffer backed by a file descriptor.
+ */
+#pragma once
+
+/* linux */
+#include <unistd.h>
+
+/* toolchain */
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+/* internal */
+#include "../buffer/FullDuplexBuffer.h"
+
+namespace Coral
+{
+
+/**
+ * Writes transmit-buffer data to a (non-blocking) file descriptor and reads
+ * from it into the receive buffer.
+ *
+ * The receive buffer is only refilled once it's empty (every pop services
+ * the buffer, this avoids a read attempt per element).
+ */
+template <std::size_t tx_depth, std::size_t rx_depth,
+          typename element_t = uint8_t>
+class FdBuffer
+    : public FullDuplexBuffer<FdBuffer<tx_depth, rx_depth, element_t>,
+                              tx_depth, rx_depth, element_t>
+{
+  public:
+    using Base = FullDuplexBuffer<FdBuffer<tx_depth, rx_depth, element_t>,
+                                  tx_depth, rx_depth, element_t>;
+    using TxBuffer = typename Base::TxBuffer;
+    using RxBuffer = typename Base::RxBuffer;
+
+    FdBuffer(int _fd, bool _auto_service = false)
+        : Base(_auto_service), fd(_fd), reads(0), writes(0), errors(0)
+    {
+    }
+
+    void service_tx_impl(TxBuffer *buf)
+    {
+        auto region = buf->read_region();
+
+        if (not region.empty())
+        {
+            ssize_t count = ::write(fd, region.data(), region.size_bytes());
+            writes++;
+
+            if (count > 0)
+            {
+                buf->pop_n(nullptr, count / sizeof(element_t));
+            }
+            else if (count < 0 and errno != EAGAIN)
+            {
+                errors++;
+            }
+        }
+    }
+
+    void service_rx_impl(RxBuffer *buf)
+    {
+        if (buf->empty())
+        {
+            element_t data[rx_depth];
+
+            ssize_t count = ::read(fd, data, sizeof(data));
+            reads++;
+
+            if (count > 0)
+            {
+                buf->push_n(data, count / sizeof(element_t));
+            }
+            else if (count < 0 and errno != EAGAIN)
+            {
+                errors++;
+            }
+        }
+    }
+
+    void poll_metrics(uint32_t &_reads, uint32_t &_writes, uint16_t &_errors,
+                      bool reset = true)
+    {
+        _reads = reads;
+        _writes = writes;
+        _errors = errors;
+
+        if (reset)
+        {
+            reads = 0;
+            writes = 0;
+            errors = 0;
+        }
+    }
+
+    const int fd;
+
+  protected:
+    /* Metrics (system calls). */
+    uint32_t reads;
+    uint32_t writes;
+    uint16_t errors;
+};
+
+} // namespace Coral
@@ -1,4 +1,9 @@
+/* linux */
+#include <fcntl.h>
+#include <unistd.h>
+
 /* internal */
+#include "../logging/macros.h"
 #include "FdManager.h"
 
 namespace Coral
@@ -14,10 +19,28 @@ FdManager::~FdManager()
     }
 }
 
+Result FdManager::add_file_fd(const std::string path, int flags,
+                              const std::string group)
+{
+    FdMap &fds = fd_group(group);
+    bool result = ToBool(get_file_fd(path, fds, flags));
+    if (result)
+    {
+        metadata.erase(fds[path]);
+    }
+    return ToResult(result);
+}
+
 Result FdManager::add_file_fd(const std::string path, const std::string mode,
                               const std::string group)
 {
-    return get_file_fd(path, fd_group(group), mode);
+    FdMap &fds = fd_group(group);
+    bool result = ToBool(get_file_fd(path, fds, mode));
+    if (result)
+    {
+        metadata.erase(fds[path]);
+    }
+    return ToResult(result);
 }
 
 FdMap &FdManager::fd_group(const std::string group)
@@ -40,6 +63,7 @@ Result FdManager::add_fd(const std::string name, int fd,
         std::cout << "Adding [" << group << "][" << name << "] = " << fd << "."
                   << std::endl;
         fds[name] = fd;
+        metadata.erase(fd);
     }
     return ToResult(result);
 }
@@ -49,4 +73,84 @@ int &FdManager::operator[](const std::string name)
     return fd_group()[name];
 }
 
+Result FdManager::close_fd(const std::string name, const std::string group)
+{
+    FdMap &fds = fd_group(group);
+    auto it = fds.find(name);
+    bool result = it != fds.end();
+
+    if (result)
+    {
+        metadata.erase(it->second);
+        result = close(it->second) == 0;
+        LogErrnoIfNot(result);
+        fds.erase(it);
+    }
+
+    return ToResult(result);
+}
+
+bool FdManager::managed(int fd)
+{
+    for (const auto &[name, fds] : groups)
+    {
+        for (const auto &[fd_name, value] : fds)
+        {
+            if (value == fd)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+Result FdManager::flags(int fd, FdFlags &result)
+{
+    auto it = metadata.find(fd);
+    if (it != metadata.end() and it->second.descriptor != unknown_flags)
+    {
+        result = it->second;
+        return ToResult(true);
+    }
+
+    bool success = ToBool(fd_flags(fd, result));
+    if (success and (it != metadata.end() or managed(fd)))
+    {
+        metadata[fd] = result;
+    }
+    return ToResult(success);
+}
+
+Result FdManager::fd_info(int fd, std::ostream &stream)
+{
+    FdFlags data;
+    return ToResult(ToBool(flags(fd, data)) and
+                    ToBool(Coral::fd_info(fd, data, stream)));
+}
+
+Result FdManager::set_blocking_state(int fd, bool blocking)
+{
+    auto it = metadata.find(fd);
+    if (it == metadata.end())
+    {
+        /* Unmanaged descriptors aren't cached. */
+        if (not managed(fd))
+        {
+            return fd_set_blocking_state(fd, blocking);
+        }
+
+        /* Only the status flags are needed. */
+        int status = fcntl(fd, F_GETFL);
+        if (status == -1)
+        {
+            LogErrno;
+            return ToResult(false);
+        }
+        it = metadata.emplace(fd, FdFlags{status, unknown_flags}).first;
+    }
+
+    return fd_set_blocking_state(fd, it->second.status, blocking);
+}
+
 } // namespace Coral
@@ -21,7 +21,7 @@ class FdManager
 
     using FdGroup = std::map<std::string, FdMap>;
 
-    FdManager() : groups()
+    FdManager() : groups(), metadata()
     {
     }
 
@@ -31,6 +31,9 @@ class FdManager
                        const std::string mode = default_open_mode,
                        const std::string group = default_group);
 
+    Result add_file_fd(const std::string path, int flags,
+                       const std::string group = default_group);
+
     FdMap &fd_group(const std::string group = default_group);
 
     Result add_fd(const std::string name, int fd,
@@ -38,8 +41,33 @@ class FdManager
 
     int &operator[](const std::string name);
 
+    /* Close a descriptor and stop managing it. */
+    Result close_fd(const std::string name,
+                    const std::string group = default_group);
+
+    /*
+     * Flags for a descriptor. Flags of managed descriptors are only queried
+     * the first time, so they must be changed through the manager.
+     */
+    Result flags(int fd, FdFlags &result);
+
+    Result fd_info(int fd, std::ostream &stream = std::cout);
+
+    Result set_blocking_state(int fd, bool blocking = false);
+
   protected:
     FdGroup groups;
+
+    /*
+     * Cached flags for managed descriptors (dropped when a descriptor is
+     * closed or its number is added again).
+     */
+    std::map<int, FdFlags> metadata;
+
+    /* Descriptor flags that haven't been queried yet. */
+    static constexpr int unknown_flags = -1;
+
+    bool managed(int fd);
 };
 
 } // namespace Coral
@@ -0,0 +1,198 @@
+/* linux */
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* toolchain */
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+/* internal */
+#include "../logging/macros.h"
+#include "IoUring.h"
+
+namespace Coral
+{
+
+IoUring::IoUring(unsigned _entries)
+    : entries(_entries), fd(-1), params(), sq_ring(MAP_FAILED),
+      sq_ring_size(0), cq_ring(MAP_FAILED), cq_ring_size(0),
+      sqes(static_cast<io_uring_sqe *>(MAP_FAILED)), sqes_size(0),
+      sq_head(nullptr), sq_tail(nullptr), sq_mask(nullptr),
+      sq_array(nullptr), sqe_tail(0), cq_head(nullptr), cq_tail(nullptr),
+      cq_mask(nullptr), cqes(nullptr), enters(0), completions(0)
+{
+    fd = syscall(__NR_io_uring_setup, entries, &params);
+
+    bool result = fd != -1 and map();
+    LogErrnoIfNot(result);
+
+    if (not result and fd != -1)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+IoUring::~IoUring()
+{
+    if (sqes != MAP_FAILED)
+    {
+        munmap(sqes, sqes_size);
+    }
+    if (cq_ring != MAP_FAILED and cq_ring != sq_ring)
+    {
+        munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring != MAP_FAILED)
+    {
+        munmap(sq_ring, sq_ring_size);
+    }
+
+    if (fd != -1)
+    {
+        LogErrnoIfNot(close(fd) == 0);
+    }
+}
+
+bool IoUring::map()
+{
+    sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    /* Newer kernels allow both rings to share one mapping. */
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+    {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        return false;
+    }
+
+    cq_ring = (single) ? sq_ring
+                       : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, fd,
+                              IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED)
+    {
+        return false;
+    }
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(
+        mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+    {
+        return false;
+    }
+
+    sq_head = offset<unsigned>(sq_ring, params.sq_off.head);
+    sq_tail = offset<unsigned>(sq_ring, params.sq_off.tail);
+    sq_mask = offset<unsigned>(sq_ring, params.sq_off.ring_mask);
+    sq_array = offset<unsigned>(sq_ring, params.sq_off.array);
+    sqe_tail = *sq_tail;
+
+    cq_head = offset<unsigned>(cq_ring, params.cq_off.head);
+    cq_tail = offset<unsigned>(cq_ring, params.cq_off.tail);
+    cq_mask = offset<unsigned>(cq_ring, params.cq_off.ring_mask);
+    cqes = offset<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+
+    return true;
+}
+
+io_uring_sqe *IoUring::get_sqe()
+{
+    if (sqe_tail - load(sq_head) >= params.sq_entries)
+    {
+        return nullptr;
+    }
+
+    unsigned index = sqe_tail & *sq_mask;
+    sqe_tail++;
+
+    sq_array[index] = index;
+
+    io_uring_sqe *sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submit(unsigned wait)
+{
+    /* Publish queued entries. */
+    store(sq_tail, sqe_tail);
+
+    int submitted = 0;
+
+    while (true)
+    {
+        /* Include entries the kernel didn't consume on a previous call. */
+        unsigned pending = sqe_tail - load(sq_head);
+
+        if (pending == 0 and wait == 0)
+        {
+            break;
+        }
+
+        enters++;
+        int result =
+            syscall(__NR_io_uring_enter, fd, pending, wait,
+                    (wait) ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            /*
+             * The kernel can refuse new work until completions are reaped
+             * (unconsumed entries stay queued for the next call).
+             */
+            LogErrnoIf(errno != EAGAIN and errno != EBUSY);
+            return (submitted) ? submitted : -1;
+        }
+
+        submitted += result;
+        wait = 0;
+
+        /* Stop when everything was consumed (or nothing more will be). */
+        if (result == 0 or unsigned(result) == pending)
+        {
+            break;
+        }
+    }
+
+    return submitted;
+}
+
+Result IoUring::register_buffers(const iovec *iovecs, unsigned count)
+{
+    return ToResult(syscall(__NR_io_uring_register, fd,
+                            IORING_REGISTER_BUFFERS, iovecs, count) == 0);
+}
+
+void IoUring::poll_metrics(uint32_t &_enters, uint32_t &_completions,
+                           bool reset)
+{
+    _enters = enters;
+    _completions = completions;
+
+    if (reset)
+    {
+        enters = 0;
+        completions = 0;
+    }
+}
+
+} // namespace Coral
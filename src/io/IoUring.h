@@ -0,0 +1,128 @@
+/**
+ * \file
+ * \brief A minimal io_uring interface (system calls only, no liburing).
+ */
+#pragma once
+
+/* linux */
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+/* toolchain */
+#include <atomic>
+#include <cstdint>
+
+/* internal */
+#include "../result.h"
+
+namespace Coral
+{
+
+static constexpr unsigned default_uring_entries = 64;
+
+/*
+ * Owns a submission and completion queue pair. Entries are queued with
+ * 'get_sqe', handed to the kernel (in one system call) with 'submit' and
+ * completions are consumed with 'reap'.
+ */
+class IoUring
+{
+  public:
+    IoUring(unsigned entries = default_uring_entries);
+    ~IoUring();
+
+    inline bool valid() const
+    {
+        return fd != -1;
+    }
+
+    /* Get a cleared submission entry (nullptr if the queue is full). */
+    io_uring_sqe *get_sqe();
+
+    /*
+     * Submit all queued entries, optionally waiting for 'wait' completions.
+     * Returns the number of entries submitted (or -1). Entries the kernel
+     * doesn't accept stay queued and are submitted by the next call.
+     */
+    int submit(unsigned wait = 0);
+
+    /* Call 'handler' with every available completion. */
+    template <typename Handler> std::size_t reap(Handler handler)
+    {
+        unsigned head = *cq_head;
+        unsigned tail = load(cq_tail);
+        std::size_t count = tail - head;
+
+        while (head != tail)
+        {
+            handler(cqes[head & *cq_mask]);
+            head++;
+
+            /* Release the entry back to the kernel. */
+            store(cq_head, head);
+        }
+
+        completions += count;
+        return count;
+    }
+
+    /* Register (pin) buffers for fixed reads and writes. */
+    Result register_buffers(const iovec *iovecs, unsigned count);
+
+    void poll_metrics(uint32_t &_enters, uint32_t &_completions,
+                      bool reset = true);
+
+    const unsigned entries;
+
+  protected:
+    int fd;
+    io_uring_params params;
+
+    /* Mapped regions. */
+    void *sq_ring;
+    std::size_t sq_ring_size;
+    void *cq_ring;
+    std::size_t cq_ring_size;
+    io_uring_sqe *sqes;
+    std::size_t sqes_size;
+
+    /* Submission queue. */
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sqe_tail;
+
+    /* Completion queue. */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    io_uring_cqe *cqes;
+
+    /* Metrics. */
+    uint32_t enters;
+    uint32_t completions;
+
+    /* Ring indices are shared with the kernel. */
+    static inline unsigned load(unsigned *index)
+    {
+        return std::atomic_ref<unsigned>(*index).load(
+            std::memory_order_acquire);
+    }
+
+    static inline void store(unsigned *index, unsigned value)
+    {
+        std::atomic_ref<unsigned>(*index).store(value,
+                                                std::memory_order_release);
+    }
+
+    template <typename T>
+    inline T *offset(void *region, uint32_t bytes)
+    {
+        return reinterpret_cast<T *>(static_cast<uint8_t *>(region) + bytes);
+    }
+
+    bool map();
+};
+
+} // namespace Coral
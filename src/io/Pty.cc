@@ -0,0 +1,50 @@
+/* linux */
+#include <fcntl.h>
+#include <unistd.h>
+
+/* toolchain */
+#include <cstdlib>
+
+/* internal */
+#include "../logging/macros.h"
+#include "Pty.h"
+#include "file_descriptors.h"
+
+namespace Coral
+{
+
+PseudoTerminal::PseudoTerminal(bool blocking)
+    : path(), primary(posix_openpt(O_RDWR | O_NOCTTY)), secondary(-1)
+{
+    bool result = primary != -1 and grantpt(primary) == 0 and
+                  unlockpt(primary) == 0;
+
+    const char *name = (result) ? ptsname(primary) : nullptr;
+    if (name)
+    {
+        path = name;
+        secondary = open(name, O_RDWR | O_NOCTTY);
+    }
+
+    result = valid();
+    if (result and not blocking)
+    {
+        result = ToBool(fd_set_blocking_state(primary, false)) and
+                 ToBool(fd_set_blocking_state(secondary, false));
+    }
+
+    LogErrnoIfNot(result);
+}
+
+PseudoTerminal::~PseudoTerminal()
+{
+    for (int fd : {secondary, primary})
+    {
+        if (fd != -1)
+        {
+            LogErrnoIfNot(close(fd) == 0);
+        }
+    }
+}
+
+} // namespace Coral
@@ -0,0 +1,38 @@
+/**
+ * \file
+ * \brief A pseudoterminal-pair interface.
+ */
+#pragma once
+
+/* toolchain */
+#include <string>
+
+/* internal */
+#include "../result.h"
+
+namespace Coral
+{
+
+/*
+ * Opens both ends of a pseudoterminal (a local stand-in for a serial link).
+ * Data written to one end can be read from the other.
+ */
+class PseudoTerminal
+{
+  public:
+    PseudoTerminal(bool blocking = false);
+    ~PseudoTerminal();
+
+    inline bool valid() const
+    {
+        return primary != -1 and secondary != -1;
+    }
+
+    /* The path of the secondary end (e.g. '/dev/pts/N'). */
+    std::string path;
+
+    int primary;
+    int secondary;
+};
+
+} // namespace Coral
@@ -0,0 +1,354 @@
+/**
+ * \file
+ * \brief An io_uring backend for groups of file descriptors.
+ */
+#pragma once
+
+/* linux */
+#include <sys/uio.h>
+
+/* toolchain */
+#include <cerrno>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* internal */
+#include "../buffer/FullDuplexBuffer.h"
+#include "IoUring.h"
+#include "file_descriptors.h"
+
+namespace Coral
+{
+
+/**
+ * A full-duplex buffer serviced by io_uring. Reads complete directly into
+ * the receive buffer's writable region and writes are issued from the
+ * transmit buffer's readable region (no intermediate copies). At most one
+ * read and one write are in flight at a time.
+ */
+template <std::size_t tx_depth, std::size_t rx_depth>
+class UringFdBuffer
+    : public FullDuplexBuffer<UringFdBuffer<tx_depth, rx_depth>, tx_depth,
+                              rx_depth, uint8_t>
+{
+  public:
+    using Base = FullDuplexBuffer<UringFdBuffer<tx_depth, rx_depth>,
+                                  tx_depth, rx_depth, uint8_t>;
+    using TxBuffer = typename Base::TxBuffer;
+    using RxBuffer = typename Base::RxBuffer;
+
+    /* The low bits of completion user data identify the operation. */
+    static constexpr uint64_t write_op = 1;
+    static constexpr uint64_t cancel_op = 2;
+
+    UringFdBuffer(IoUring &_ring, int _fd)
+        : Base(false), fd(_fd), ring(_ring), fixed_index(-1), reading(false),
+          writing(false), stopping(false), eof(false), errors(0)
+    {
+    }
+
+    /* Use registered buffers ('index' is the transmit buffer's). */
+    inline void set_fixed(int index)
+    {
+        fixed_index = index;
+    }
+
+    void service_tx_impl(TxBuffer *buf)
+    {
+        if (not writing and not stopping)
+        {
+            auto region = buf->read_region();
+            writing = not region.empty() and
+                      prepare(IORING_OP_WRITE, region.data(), region.size(),
+                              0, write_op);
+        }
+    }
+
+    void service_rx_impl(RxBuffer *buf)
+    {
+        if (not reading and not eof and not stopping)
+        {
+            auto region = buf->write_region();
+            reading = not region.empty() and
+                      prepare(IORING_OP_READ, region.data(), region.size(),
+                              1, 0);
+        }
+    }
+
+    void complete(bool write, int32_t res)
+    {
+        if (write)
+        {
+            writing = false;
+            if (res > 0)
+            {
+                this->tx.pop_n(nullptr, res);
+            }
+            else if (res < 0 and res != -ECANCELED)
+            {
+                errors++;
+            }
+
+            /* Write anything that remains (or was added since). */
+            this->service_tx(&this->tx);
+        }
+        else
+        {
+            reading = false;
+            if (res > 0)
+            {
+                this->rx.commit_write(res);
+            }
+            else if (res == 0)
+            {
+                eof = true;
+            }
+            else if (res != -ECANCELED)
+            {
+                errors++;
+            }
+
+            this->service_rx(&this->rx);
+        }
+    }
+
+    inline bool closed() const
+    {
+        return eof;
+    }
+
+    inline bool in_flight() const
+    {
+        return reading or writing;
+    }
+
+    /*
+     * Stop issuing operations and request cancellation of any in flight
+     * (their completions still have to be reaped). Requesting again is
+     * harmless.
+     */
+    void cancel(void)
+    {
+        stopping = true;
+
+        if (reading)
+        {
+            prepare_cancel(0);
+        }
+        if (writing)
+        {
+            prepare_cancel(write_op);
+        }
+    }
+
+    void poll_metrics(uint16_t &_errors, bool reset = true)
+    {
+        _errors = errors;
+
+        if (reset)
+        {
+            errors = 0;
+        }
+    }
+
+    const int fd;
+
+  protected:
+    IoUring &ring;
+    int fixed_index;
+
+    /* Operations in flight. */
+    bool reading;
+    bool writing;
+    bool stopping;
+
+    bool eof;
+    uint16_t errors;
+
+    bool prepare(uint8_t opcode, uint8_t *data, std::size_t size,
+                 int buffer_offset, uint64_t op)
+    {
+        io_uring_sqe *sqe = ring.get_sqe();
+
+        /* Retried the next time this buffer is serviced. */
+        if (not sqe)
+        {
+            return false;
+        }
+
+        sqe->opcode = opcode;
+        if (fixed_index >= 0)
+        {
+            sqe->opcode = (opcode == IORING_OP_READ) ? IORING_OP_READ_FIXED
+                                                     : IORING_OP_WRITE_FIXED;
+            sqe->buf_index = fixed_index + buffer_offset;
+        }
+
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = size;
+
+        /* Use (and update) the current file position. */
+        sqe->off = -1;
+
+        sqe->user_data = reinterpret_cast<uint64_t>(this) | op;
+        return true;
+    }
+
+    void prepare_cancel(uint64_t op)
+    {
+        io_uring_sqe *sqe = ring.get_sqe();
+
+        /* Retried the next time this buffer is cancelled. */
+        if (sqe)
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<uint64_t>(this) | op;
+            sqe->user_data = reinterpret_cast<uint64_t>(this) | cancel_op;
+        }
+    }
+};
+
+/**
+ * Services every file descriptor in a group with a single ring: all pending
+ * reads and writes are submitted with one system call per poll, and buffers
+ * are serviced again as their operations complete.
+ */
+template <std::size_t tx_depth, std::size_t rx_depth> class UringBackend
+{
+  public:
+    using Buffer = UringFdBuffer<tx_depth, rx_depth>;
+
+    UringBackend(const FdMap &group,
+                 unsigned entries = default_uring_entries)
+        : buffers(), ring(entries), fixed(false)
+    {
+        std::vector<iovec> iovecs;
+
+        for (const auto &[name, fd] : group)
+        {
+            auto buffer = std::make_unique<Buffer>(ring, fd);
+
+            auto tx = buffer->tx.storage();
+            auto rx = buffer->rx.storage();
+            buffer->set_fixed(iovecs.size());
+            iovecs.push_back({tx.data(), tx.size_bytes()});
+            iovecs.push_back({rx.data(), rx.size_bytes()});
+
+            buffers[name] = std::move(buffer);
+        }
+
+        /*
+         * Pin every buffer once up front (fall back to regular reads and
+         * writes if that's not allowed, e.g. due to memory limits).
+         */
+        fixed = ring.valid() and not iovecs.empty() and
+                ToBool(ring.register_buffers(iovecs.data(), iovecs.size()));
+        if (not fixed)
+        {
+            for (auto &[name, buffer] : buffers)
+            {
+                buffer->set_fixed(-1);
+            }
+        }
+    }
+
+    /*
+     * Cancel (and wait for) every operation in flight, so that the kernel
+     * is done with the buffers before they're freed.
+     */
+    ~UringBackend()
+    {
+        while (ring.valid() and in_flight())
+        {
+            for (auto &[name, buffer] : buffers)
+            {
+                buffer->cancel();
+            }
+
+            if (ring.submit(1) < 0)
+            {
+                break;
+            }
+            ring.reap(complete);
+        }
+    }
+
+    inline bool valid() const
+    {
+        return ring.valid();
+    }
+
+    inline bool registered() const
+    {
+        return fixed;
+    }
+
+    inline Buffer &operator[](const std::string &name)
+    {
+        return *buffers.at(name);
+    }
+
+    /*
+     * Queue operations for every buffer, submit them and handle completions
+     * (waiting for up to 'wait' of them). Returns the number of completions
+     * handled.
+     */
+    std::size_t poll(unsigned wait = 0)
+    {
+        for (auto &[name, buffer] : buffers)
+        {
+            buffer->dispatch();
+        }
+
+        ring.submit(wait);
+
+        return ring.reap(complete);
+    }
+
+    inline void poll_metrics(uint32_t &enters, uint32_t &completions,
+                             bool reset = true)
+    {
+        ring.poll_metrics(enters, completions, reset);
+    }
+
+  protected:
+    /* Declared first: the ring is closed before the buffers are freed. */
+    std::map<std::string, std::unique_ptr<Buffer>> buffers;
+    IoUring ring;
+    bool fixed;
+
+    /* Buffers are aligned, which leaves room for the operation bits. */
+    static_assert(alignof(Buffer) > (Buffer::write_op | Buffer::cancel_op));
+
+    inline bool in_flight() const
+    {
+        for (const auto &[name, buffer] : buffers)
+        {
+            if (buffer->in_flight())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void complete(const io_uring_cqe &cqe)
+    {
+        /* Cancellation requests finish on their own. */
+        if (cqe.user_data & Buffer::cancel_op)
+        {
+            return;
+        }
+
+        auto buffer = reinterpret_cast<Buffer *>(cqe.user_data &
+                                                 ~Buffer::write_op);
+        buffer->complete(cqe.user_data & Buffer::write_op, cqe.res);
+    }
+};
+
+} // namespace Coral
@@ -24,23 +24,70 @@ void close_fds(const FdMap &fds)
     }
 }
 
+int open_flags(const std::string mode)
+{
+    static const std::map<char, int> access_modes = {
+        {'r', O_RDONLY},
+        {'w', O_WRONLY | O_CREAT | O_TRUNC},
+        {'a', O_WRONLY | O_CREAT | O_APPEND},
+    };
+
+    if (mode.empty() or not access_modes.contains(mode[0]))
+    {
+        return -1;
+    }
+
+    int flags = access_modes.at(mode[0]);
+
+    for (char modifier : mode.substr(1))
+    {
+        switch (modifier)
+        {
+        case '+':
+            flags = (flags & ~O_ACCMODE) | O_RDWR;
+            break;
+        case 'b':
+            break;
+        case 'x':
+            flags |= O_EXCL;
+            break;
+        case 'e':
+            flags |= O_CLOEXEC;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    return flags;
+}
+
 Result get_file_fd(const std::string path, FdMap &fds, const std::string mode)
+{
+    int flags = open_flags(mode);
+    bool result = flags != -1;
+
+    if (not result)
+    {
+        errno = EINVAL;
+        LogErrno;
+    }
+
+    return (result) ? get_file_fd(path, fds, flags) : ToResult(result);
+}
+
+Result get_file_fd(const std::string path, FdMap &fds, int flags,
+                   mode_t permissions)
 {
     bool result = not fds.contains(path);
 
     if (result)
     {
-        FILE *file = std::fopen(path.data(), mode.data());
-        result = file != nullptr;
-
+        int fd = open(path.data(), flags, permissions);
+        result = fd != -1;
         if (result)
         {
-            int fd = fileno(file);
-            result = fd != -1;
-            if (result)
-            {
-                fds[path] = fd;
-            }
+            fds[path] = fd;
         }
 
         LogErrnoIfNot(result);
@@ -76,42 +123,50 @@ static void dump_fd_status_flags(int flags, std::ostream &stream)
                             false /* endl */);
 }
 
-Result fd_info(int fd, std::ostream &stream)
+Result fd_flags(int fd, FdFlags &flags)
 {
-    /* Get status flags. */
-    int flags = fcntl(fd, F_GETFL);
-    bool success = flags != -1;
+    flags.status = fcntl(fd, F_GETFL);
+    flags.descriptor = fcntl(fd, F_GETFD);
+
+    bool success = flags.status != -1 and flags.descriptor != -1;
     LogErrnoIfNot(success);
 
+    return ToResult(success);
+}
+
+Result fd_info(int fd, std::ostream &stream)
+{
+    FdFlags flags;
+    return ToResult(ToBool(fd_flags(fd, flags)) and
+                    ToBool(fd_info(fd, flags, stream)));
+}
+
+Result fd_info(int fd, const FdFlags &flags, std::ostream &stream)
+{
     std::string fd_string = "fd(" + std::to_string(fd) + ")";
 
     /* Print info about flags. */
-    if (success)
-    {
-        stream << fd_string << ": ";
-        dump_fd_status_flags(flags, stream);
+    stream << fd_string << ": ";
+    dump_fd_status_flags(flags.status, stream);
 
-        /* Get status flags. */
-        flags = fcntl(fd, F_GETFD);
-        if (flags != -1 and flags & FD_CLOEXEC)
-        {
-            stream << ", FD_CLOEXEC=" << FD_CLOEXEC;
-        }
+    if (flags.descriptor & FD_CLOEXEC)
+    {
+        stream << ", FD_CLOEXEC=" << FD_CLOEXEC;
+    }
 
-        stream << std::endl;
+    stream << std::endl;
 
-        /* Dump terminal information. */
-        if (isatty(fd))
+    /* Dump terminal information. */
+    if (isatty(fd))
+    {
+        struct termios data;
+        if (tcgetattr(fd, &data) == 0)
         {
-            struct termios data;
-            if (tcgetattr(fd, &data) == 0)
-            {
-                dump_term_all(stream, fd, data);
-            }
+            dump_term_all(stream, fd, data);
         }
     }
 
-    return ToResult(success);
+    return ToResult(true);
 }
 
 Result fd_set_blocking_state(int fd, bool blocking)
@@ -129,4 +184,19 @@ Result fd_set_blocking_state(int fd, bool blocking)
     return ToResult(success);
 }
 
+Result fd_set_blocking_state(int fd, int &status_flags, bool blocking)
+{
+    int flags = blocking ? status_flags & ~O_NONBLOCK
+                         : status_flags | O_NONBLOCK;
+
+    /* Avoid the system call if nothing changes. */
+    bool success = flags == status_flags or fcntl(fd, F_SETFL, flags) != -1;
+    if (success)
+    {
+        status_flags = flags;
+    }
+
+    return ToResult(success);
+}
+
 } // namespace Coral
@@ -4,6 +4,9 @@
  */
 #pragma once
 
+/* linux */
+#include <sys/types.h>
+
 /* toolchain */
 #include <iostream>
 #include <map>
@@ -20,12 +23,38 @@ using FdMap = std::map<std::string, int>;
 void close_fds(const FdMap &fds);
 
 static constexpr std::string default_open_mode = "r+";
+static constexpr mode_t default_open_permissions = 0666;
+
+/*
+ * Convert an fopen-style mode string to open(2) flags ('b' is ignored, 'x'
+ * adds O_EXCL and 'e' adds O_CLOEXEC). Returns -1 if the mode is invalid.
+ */
+int open_flags(const std::string mode);
 
 Result get_file_fd(const std::string path, FdMap &fds,
                    const std::string mode = default_open_mode);
 
+/* Open a file with explicit 'O_*' flags (e.g. O_NONBLOCK, O_CLOEXEC). */
+Result get_file_fd(const std::string path, FdMap &fds, int flags,
+                   mode_t permissions = default_open_permissions);
+
+/* Status (F_GETFL) and descriptor (F_GETFD) flags. */
+struct FdFlags
+{
+    int status;
+    int descriptor;
+};
+
+Result fd_flags(int fd, FdFlags &flags);
+
 Result fd_info(int fd, std::ostream &stream = std::cout);
 
+Result fd_info(int fd, const FdFlags &flags, std::ostream &stream = std::cout);
+
 Result fd_set_blocking_state(int fd, bool blocking = false);
 
+/* Set the blocking state with known status flags (updated in place). */
+Result fd_set_blocking_state(int fd, int &status_flags,
+                             bool blocking = false);
+
 } // namespace Coral
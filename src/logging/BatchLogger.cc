@@ -0,0 +1,381 @@
+/* toolchain */
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <limits>
+
+/* internal */
+#include "BatchLogger.h"
+#include "macros.h"
+
+namespace Coral
+{
+
+static std::atomic<uint64_t> next_id = 0;
+
+static constexpr FdBatchLogger::Clock::rep no_pending =
+    std::numeric_limits<FdBatchLogger::Clock::rep>::max();
+
+/*
+ * Loggers are looked up by identifier (never reused) without taking a lock.
+ * Buffers are handed back when the thread exits, to be reused by the next
+ * thread to register (or freed by the next flush).
+ */
+struct FdBatchLogger::ThreadBuffers
+{
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> entries;
+
+    ~ThreadBuffers()
+    {
+        for (auto &[owner, buffer] : entries)
+        {
+            std::lock_guard<std::mutex> guard(buffer->lock);
+            buffer->exited = true;
+        }
+    }
+};
+
+FdBatchLogger::ThreadBuffers &FdBatchLogger::local_buffers(void)
+{
+    static thread_local ThreadBuffers buffers;
+    return buffers;
+}
+
+static bool write_all(int fd, std::vector<struct iovec> &iov, uint32_t &writes)
+{
+    std::size_t index = 0;
+
+    while (index < iov.size())
+    {
+        int count = std::min<std::size_t>(iov.size() - index, IOV_MAX);
+
+        ssize_t written = writev(fd, &iov[index], count);
+        writes++;
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        /* Advance past everything written (handles partial writes). */
+        std::size_t remaining = written;
+        while (remaining and index < iov.size())
+        {
+            auto &vec = iov[index];
+            if (remaining >= vec.iov_len)
+            {
+                remaining -= vec.iov_len;
+                index++;
+            }
+            else
+            {
+                vec.iov_base = static_cast<char *>(vec.iov_base) + remaining;
+                vec.iov_len -= remaining;
+                remaining = 0;
+            }
+        }
+    }
+
+    return true;
+}
+
+FdBatchLogger::FdBatchLogger(int _fd, std::size_t _flush_bytes,
+                             Clock::duration _max_age, bool background_flush)
+    : fd(_fd), flush_bytes(_flush_bytes), max_age(_max_age), id(++next_id),
+      threads_lock(), threads(), merged(), iov(), flusher_lock(),
+      flusher_wake(), flusher(), pending_bytes(0), oldest_pending(no_pending),
+      writes(0), records(0), truncated(0)
+{
+    if (background_flush)
+    {
+        flusher = std::jthread(
+            [this](std::stop_token token) { run_flusher(token); });
+    }
+}
+
+FdBatchLogger::~FdBatchLogger()
+{
+    /* Stop the background thread before the final flush. */
+    if (flusher.joinable())
+    {
+        flusher.request_stop();
+        flusher.join();
+    }
+
+    flush();
+
+    /* Threads that are still running drop their buffers later. */
+    std::lock_guard<std::mutex> guard(threads_lock);
+    for (auto &buffer : threads)
+    {
+        std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+        buffer->detached = true;
+    }
+}
+
+FdBatchLogger::ThreadBuffer &FdBatchLogger::thread_buffer(void)
+{
+    auto &local = local_buffers();
+
+    for (auto &[owner, buffer] : local.entries)
+    {
+        if (owner == id)
+        {
+            return *buffer;
+        }
+    }
+
+    /* First use on this thread (forget loggers that were destroyed). */
+    std::erase_if(local.entries, [](auto &entry) {
+        std::lock_guard<std::mutex> guard(entry.second->lock);
+        return entry.second->detached;
+    });
+
+    std::shared_ptr<ThreadBuffer> result;
+    {
+        std::lock_guard<std::mutex> guard(threads_lock);
+
+        /* Take over an exited thread's buffer (pending records and all). */
+        for (auto &buffer : threads)
+        {
+            std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+            if (buffer->exited)
+            {
+                buffer->exited = false;
+                result = buffer;
+                break;
+            }
+        }
+
+        if (not result)
+        {
+            result = std::make_shared<ThreadBuffer>();
+            threads.push_back(result);
+        }
+    }
+    local.entries.emplace_back(id, result);
+
+    return *result;
+}
+
+void FdBatchLogger::release_exited(void)
+{
+    std::erase_if(threads, [](auto &buffer) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        return buffer->exited and buffer->num_records == 0;
+    });
+}
+
+bool FdBatchLogger::append(ThreadBuffer &buffer, const char *fmt,
+                           va_list args)
+{
+    std::size_t remaining = buffer.data.size() - buffer.used;
+
+    /* Need room for a record and at least one element plus terminator. */
+    if (buffer.num_records >= buffer.records.size() or remaining < 2)
+    {
+        return false;
+    }
+
+    char *head = &buffer.data[buffer.used];
+
+    va_list copy;
+    va_copy(copy, args);
+    int written = vsnprintf(head, remaining, fmt, copy);
+    va_end(copy);
+
+    /* Encoding errors produce no output. */
+    if (written < 0)
+    {
+        return true;
+    }
+
+    std::size_t length = written;
+    if (length >= remaining)
+    {
+        /* Only truncate when this record can't fit in an empty buffer. */
+        if (buffer.num_records)
+        {
+            return false;
+        }
+
+        length = remaining - 1;
+        truncated++;
+    }
+
+    auto now = Clock::now();
+    buffer.records[buffer.num_records++] = {now, head, length};
+    buffer.used += length;
+
+    /* Update flush-threshold state. */
+    pending_bytes += length;
+
+    auto stamp = now.time_since_epoch().count();
+    auto current = oldest_pending.load();
+    while (stamp < current and
+           not oldest_pending.compare_exchange_weak(current, stamp))
+    {
+    }
+
+    return true;
+}
+
+bool FdBatchLogger::should_flush(Clock::time_point now)
+{
+    auto oldest = oldest_pending.load();
+
+    return pending_bytes >= flush_bytes or
+           (oldest != no_pending and
+            now.time_since_epoch().count() - oldest >= max_age.count());
+}
+
+void FdBatchLogger::vlog_impl(const char *fmt, va_list args)
+{
+    auto &buffer = thread_buffer();
+    bool appended;
+
+    {
+        std::lock_guard<std::mutex> guard(buffer.lock);
+        appended = append(buffer, fmt, args);
+    }
+
+    /* Make room (only this thread appends to its buffer) and retry. */
+    if (not appended)
+    {
+        flush();
+
+        std::lock_guard<std::mutex> guard(buffer.lock);
+        appended = append(buffer, fmt, args);
+        assert(appended);
+        (void)appended;
+    }
+
+    if (should_flush(Clock::now()))
+    {
+        flush();
+    }
+}
+
+void FdBatchLogger::dispatch(void)
+{
+    if (should_flush(Clock::now()))
+    {
+        flush();
+    }
+}
+
+void FdBatchLogger::run_flusher(std::stop_token token)
+{
+    /* Records are written at most one and a half thresholds old. */
+    auto period = std::max<Clock::duration>(max_age / 2, Clock::duration(1));
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(flusher_lock);
+            flusher_wake.wait_for(guard, token, period, [] { return false; });
+        }
+
+        if (token.stop_requested())
+        {
+            break;
+        }
+
+        dispatch();
+    }
+}
+
+Result FdBatchLogger::flush(void)
+{
+    bool result = true;
+    int error = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(threads_lock);
+        result = flush_locked(error);
+    }
+
+    /* Report errors without any locks held (this may be the error logger). */
+    if (not result)
+    {
+        errno = error;
+        LogErrno;
+    }
+
+    return ToResult(result);
+}
+
+bool FdBatchLogger::flush_locked(int &error)
+{
+    /* Collect every pending record (buffers stay locked until written). */
+    merged.clear();
+    for (auto &buffer : threads)
+    {
+        buffer->lock.lock();
+        merged.insert(merged.end(), buffer->records.begin(),
+                      buffer->records.begin() + buffer->num_records);
+    }
+
+    pending_bytes = 0;
+    oldest_pending = no_pending;
+
+    bool result = true;
+
+    if (not merged.empty())
+    {
+        std::stable_sort(merged.begin(), merged.end(),
+                         [](const Record &lhs, const Record &rhs) {
+                             return lhs.timestamp < rhs.timestamp;
+                         });
+
+        iov.clear();
+        for (const auto &record : merged)
+        {
+            if (record.length)
+            {
+                iov.push_back({const_cast<char *>(record.data),
+                               record.length});
+            }
+        }
+
+        uint32_t count = 0;
+        result = write_all(fd, iov, count);
+        if (not result)
+        {
+            error = errno;
+        }
+
+        writes += count;
+        records += merged.size();
+    }
+
+    for (auto &buffer : threads)
+    {
+        buffer->reset();
+        buffer->lock.unlock();
+    }
+    release_exited();
+
+    return result;
+}
+
+void FdBatchLogger::poll_metrics(uint32_t &_writes, uint32_t &_records,
+                                 uint16_t &_truncated, bool reset)
+{
+    _writes = writes;
+    _records = records;
+    _truncated = truncated;
+    if (reset)
+    {
+        writes = 0;
+        records = 0;
+        truncated = 0;
+    }
+}
+
+} // namespace Coral
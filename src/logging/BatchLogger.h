@@ -0,0 +1,154 @@
+/**
+ * \file
+ * \brief A logger that batches records per thread and writes them with
+ *        writev.
+ */
+#pragma once
+
+/* toolchain */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/* linux */
+#include <sys/uio.h>
+
+/* internal */
+#include "../result.h"
+#include "LogInterface.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_batch_depth = BUFSIZ;
+static constexpr std::size_t default_batch_records = 64;
+
+/**
+ * Accumulates formatted records in per-thread buffers. Buffers are merged
+ * (ordered by a monotonic timestamp) and written to the file descriptor
+ * with as few writev calls as possible when:
+ *
+ * - pending bytes (across all threads) reach a size threshold,
+ * - the oldest pending record exceeds an age threshold (checked when logging,
+ *   in \ref dispatch and, unless disabled, by a background thread every half
+ *   threshold, so records from threads that stop logging are still written),
+ *   or
+ * - \ref flush is called explicitly (also done on destruction).
+ */
+class FdBatchLogger : public LogInterface<FdBatchLogger>
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr Clock::duration default_max_age =
+        std::chrono::milliseconds(100);
+
+    FdBatchLogger(int _fd, std::size_t _flush_bytes = default_batch_depth,
+                  Clock::duration _max_age = default_max_age,
+                  bool background_flush = true);
+    ~FdBatchLogger();
+
+    void vlog_impl(const char *fmt, va_list args);
+
+    /* Write all pending records. */
+    Result flush(void);
+
+    /* Flush if the oldest pending record has exceeded the age threshold. */
+    void dispatch(void);
+
+    void poll_metrics(uint32_t &_writes, uint32_t &_records,
+                      uint16_t &_truncated, bool reset = true);
+
+  protected:
+    struct Record
+    {
+        Clock::time_point timestamp;
+        const char *data;
+        std::size_t length;
+    };
+
+    /*
+     * Shared by the logger and the thread that appends to it, so that either
+     * can go away first.
+     */
+    struct ThreadBuffer
+    {
+        std::mutex lock;
+
+        /* The thread exited (the logger reuses or frees it). */
+        bool exited = false;
+
+        /* The logger was destroyed (the thread drops it). */
+        bool detached = false;
+
+        std::array<char, default_batch_depth> data;
+        std::size_t used = 0;
+
+        std::array<Record, default_batch_records> records;
+        std::size_t num_records = 0;
+
+        inline void reset(void)
+        {
+            used = 0;
+            num_records = 0;
+        }
+    };
+
+    /* The calling thread's buffers (one per logger it has used). */
+    struct ThreadBuffers;
+    static ThreadBuffers &local_buffers(void);
+
+    const int fd;
+    const std::size_t flush_bytes;
+    const Clock::duration max_age;
+
+    /* Distinguishes instances for per-thread buffer lookup. */
+    const uint64_t id;
+
+    /* Registered per-thread buffers (and flush serialization). */
+    std::mutex threads_lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+
+    /* Flush staging (only used with 'threads_lock' held). */
+    std::vector<Record> merged;
+    std::vector<struct iovec> iov;
+
+    /* Checks the age threshold periodically (if enabled). */
+    std::mutex flusher_lock;
+    std::condition_variable_any flusher_wake;
+    std::jthread flusher;
+
+    /* Pending state used to evaluate flush thresholds. */
+    std::atomic<std::size_t> pending_bytes;
+    std::atomic<Clock::rep> oldest_pending;
+
+    /* Metrics. */
+    std::atomic<uint32_t> writes;
+    std::atomic<uint32_t> records;
+    std::atomic<uint16_t> truncated;
+
+    ThreadBuffer &thread_buffer(void);
+
+    /* Write all pending records ('threads_lock' held), setting 'error'. */
+    bool flush_locked(int &error);
+
+    /* Free the empty buffers of exited threads ('threads_lock' held). */
+    void release_exited(void);
+
+    bool append(ThreadBuffer &buffer, const char *fmt, va_list args);
+
+    bool should_flush(Clock::time_point now);
+
+    void run_flusher(std::stop_token token);
+};
+
+}; // namespace Coral
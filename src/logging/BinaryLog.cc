@@ -0,0 +1,589 @@
+/* toolchain */
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+/* internal */
+#include "BinaryLog.h"
+
+namespace Coral::BinaryLog
+{
+
+/* The wire format's widths for 'int' and floating-point arguments. */
+static_assert(sizeof(int) == sizeof(int32_t));
+static_assert(std::numeric_limits<double>::is_iec559);
+
+enum class ArgType
+{
+    none, /* '%%' */
+    int_arg,
+    long_arg,
+    long_long_arg,
+    intmax_arg,
+    size_arg,
+    ptrdiff_arg,
+    double_arg,
+    long_double_arg,
+    string_arg,
+    pointer_arg,
+    count_arg, /* '%n' (consumed, never written) */
+    invalid,
+};
+
+struct Spec
+{
+    const char *start;
+    const char *end;
+    const char *modifier = nullptr;   /* Length modifier (if any). */
+    const char *conversion = nullptr; /* Conversion character. */
+    bool star_width = false;
+    bool star_precision = false;
+    ArgType type = ArgType::invalid;
+};
+
+static inline bool is_one_of(char value, const char *options)
+{
+    return value and std::strchr(options, value);
+}
+
+static inline void skip_digits(const char *&ptr)
+{
+    while (*ptr >= '0' and *ptr <= '9')
+    {
+        ptr++;
+    }
+}
+
+/* Parse a conversion specification ('start' points at the '%'). */
+static Spec parse_spec(const char *start)
+{
+    Spec spec{start, start + 1};
+    const char *ptr = start + 1;
+
+    if (*ptr == '%')
+    {
+        spec.type = ArgType::none;
+        spec.end = ptr + 1;
+        return spec;
+    }
+
+    /* Flags. */
+    while (is_one_of(*ptr, "-+ #0'"))
+    {
+        ptr++;
+    }
+
+    /* Width. */
+    if (*ptr == '*')
+    {
+        spec.star_width = true;
+        ptr++;
+    }
+    else
+    {
+        skip_digits(ptr);
+    }
+
+    /* Precision. */
+    if (*ptr == '.')
+    {
+        ptr++;
+        if (*ptr == '*')
+        {
+            spec.star_precision = true;
+            ptr++;
+        }
+        else
+        {
+            skip_digits(ptr);
+        }
+    }
+
+    /* Length modifier. */
+    spec.modifier = ptr;
+    ArgType integer = ArgType::int_arg;
+    bool long_double = false;
+    bool wide = false;
+
+    switch (*ptr)
+    {
+    case 'h':
+        ptr += (ptr[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        if (ptr[1] == 'l')
+        {
+            integer = ArgType::long_long_arg;
+            ptr += 2;
+        }
+        else
+        {
+            integer = ArgType::long_arg;
+            wide = true;
+            ptr++;
+        }
+        break;
+    case 'q':
+        integer = ArgType::long_long_arg;
+        ptr++;
+        break;
+    case 'L':
+        long_double = true;
+        integer = ArgType::long_long_arg;
+        ptr++;
+        break;
+    case 'j':
+        integer = ArgType::intmax_arg;
+        ptr++;
+        break;
+    case 'z':
+        integer = ArgType::size_arg;
+        ptr++;
+        break;
+    case 't':
+        integer = ArgType::ptrdiff_arg;
+        ptr++;
+        break;
+    }
+
+    /* Conversion. */
+    spec.conversion = ptr;
+    if (is_one_of(*ptr, "diouxXc"))
+    {
+        /* Wide characters are promoted to 'wint_t' (same as int). */
+        spec.type = (*ptr == 'c') ? ArgType::int_arg : integer;
+    }
+    else if (is_one_of(*ptr, "fFeEgGaA"))
+    {
+        spec.type = (long_double) ? ArgType::long_double_arg
+                                  : ArgType::double_arg;
+    }
+    else if (*ptr == 's' and not wide)
+    {
+        spec.type = ArgType::string_arg;
+    }
+    else if (*ptr == 'p')
+    {
+        spec.type = ArgType::pointer_arg;
+    }
+    else if (*ptr == 'n')
+    {
+        spec.type = ArgType::count_arg;
+    }
+
+    if (*ptr)
+    {
+        ptr++;
+    }
+    spec.end = ptr;
+
+    return spec;
+}
+
+/*
+ * Packing.
+ */
+
+class Packer
+{
+  public:
+    Packer(uint8_t *_data, std::size_t _size)
+        : data(_data), size(_size), index(0)
+    {
+    }
+
+    /* Store an integer in 'wire_t' bits (little endian). */
+    template <typename wire_t, typename value_t> bool put(value_t value)
+    {
+        bool result = index + sizeof(wire_t) <= size;
+        if (result)
+        {
+            store_le(&data[index],
+                     static_cast<uint64_t>(static_cast<wire_t>(value)),
+                     sizeof(wire_t));
+            index += sizeof(wire_t);
+        }
+        return result;
+    }
+
+    bool put_double(double value)
+    {
+        return put<uint64_t>(std::bit_cast<uint64_t>(value));
+    }
+
+    bool put_string(const char *value)
+    {
+        if (not value)
+        {
+            value = "(null)";
+        }
+
+        if (index + sizeof(uint16_t) > size)
+        {
+            return false;
+        }
+
+        std::size_t length = std::strlen(value);
+        std::size_t limit = std::min<std::size_t>(
+            size - index - sizeof(uint16_t), UINT16_MAX);
+        bool result = length <= limit;
+
+        length = std::min(length, limit);
+        put<uint16_t>(length);
+        std::memcpy(&data[index], value, length);
+        index += length;
+
+        return result;
+    }
+
+    uint8_t *data;
+    std::size_t size;
+    std::size_t index;
+};
+
+std::size_t pack(const char *fmt, va_list args, uint8_t *data,
+                 std::size_t size, bool &incomplete)
+{
+    Packer packer(data, size);
+    bool ok = true;
+
+    const char *ptr = fmt;
+    while (ok and (ptr = std::strchr(ptr, '%')))
+    {
+        Spec spec = parse_spec(ptr);
+        ptr = spec.end;
+
+        if (spec.type == ArgType::invalid)
+        {
+            break;
+        }
+
+        if (spec.star_width)
+        {
+            ok = packer.put<int32_t>(va_arg(args, int));
+        }
+        if (ok and spec.star_precision)
+        {
+            ok = packer.put<int32_t>(va_arg(args, int));
+        }
+        if (not ok)
+        {
+            break;
+        }
+
+        switch (spec.type)
+        {
+        case ArgType::int_arg:
+            ok = packer.put<int32_t>(va_arg(args, int));
+            break;
+        case ArgType::long_arg:
+            ok = packer.put<int64_t>(va_arg(args, long));
+            break;
+        case ArgType::long_long_arg:
+            ok = packer.put<int64_t>(va_arg(args, long long));
+            break;
+        case ArgType::intmax_arg:
+            ok = packer.put<int64_t>(va_arg(args, intmax_t));
+            break;
+        case ArgType::size_arg:
+            ok = packer.put<uint64_t>(va_arg(args, std::size_t));
+            break;
+        case ArgType::ptrdiff_arg:
+            ok = packer.put<int64_t>(va_arg(args, std::ptrdiff_t));
+            break;
+        case ArgType::double_arg:
+            ok = packer.put_double(va_arg(args, double));
+            break;
+        case ArgType::long_double_arg:
+            ok = packer.put_double(va_arg(args, long double));
+            break;
+        case ArgType::string_arg:
+            ok = packer.put_string(va_arg(args, const char *));
+            break;
+        case ArgType::pointer_arg:
+            ok = packer.put<uint64_t>(
+                reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+            break;
+        case ArgType::count_arg:
+            (void)va_arg(args, void *);
+            break;
+        case ArgType::none:
+        case ArgType::invalid:
+            break;
+        }
+    }
+
+    incomplete = not ok;
+    return packer.index;
+}
+
+/*
+ * Decoding.
+ */
+
+class Unpacker
+{
+  public:
+    Unpacker(const uint8_t *_data, std::size_t _size)
+        : data(_data), size(_size), index(0)
+    {
+    }
+
+    /* Load an integer stored in 'wire_t' bits (little endian). */
+    template <typename wire_t> bool get(wire_t &value)
+    {
+        bool result = index + sizeof(wire_t) <= size;
+        if (result)
+        {
+            value = static_cast<wire_t>(
+                load_le(&data[index], sizeof(wire_t)));
+            index += sizeof(wire_t);
+        }
+        return result;
+    }
+
+    bool get_string(std::string &value)
+    {
+        uint16_t length;
+        bool result = get(length) and index + length <= size;
+        if (result)
+        {
+            value.assign(reinterpret_cast<const char *>(&data[index]),
+                         length);
+            index += length;
+        }
+        return result;
+    }
+
+    const uint8_t *data;
+    std::size_t size;
+    std::size_t index;
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+
+template <typename value_t>
+static void format_one(const std::string &spec, const Spec &info, int width,
+                       int precision, value_t value, std::ostream &stream)
+{
+    char buf[BUFSIZ];
+    int result;
+
+    if (info.star_width and info.star_precision)
+    {
+        result = snprintf(buf, sizeof(buf), spec.c_str(), width, precision,
+                          value);
+    }
+    else if (info.star_width)
+    {
+        result = snprintf(buf, sizeof(buf), spec.c_str(), width, value);
+    }
+    else if (info.star_precision)
+    {
+        result = snprintf(buf, sizeof(buf), spec.c_str(), precision, value);
+    }
+    else
+    {
+        result = snprintf(buf, sizeof(buf), spec.c_str(), value);
+    }
+
+    if (result > 0)
+    {
+        stream.write(buf, std::min<std::size_t>(result, sizeof(buf) - 1));
+    }
+}
+
+#pragma GCC diagnostic pop
+
+/*
+ * Format an argument stored as 'wire_t' as a 'value_t' (the type 'spec'
+ * expects on this host).
+ */
+template <typename wire_t, typename value_t = wire_t>
+static bool format_arg(Unpacker &unpacker, const std::string &spec,
+                       const Spec &info, int width, int precision,
+                       std::ostream &stream)
+{
+    wire_t value;
+    bool result = unpacker.get(value);
+    if (result)
+    {
+        format_one(spec, info, width, precision, static_cast<value_t>(value),
+                   stream);
+    }
+    return result;
+}
+
+/* Rewrite a specification's length modifier (e.g. for wire widths). */
+static std::string with_modifier(const Spec &info, const char *modifier)
+{
+    return std::string(info.start, info.modifier) + modifier +
+           std::string(info.conversion, info.end);
+}
+
+bool Decoder::render(const std::string &fmt, const uint8_t *data,
+                     std::size_t size, std::ostream &stream)
+{
+    Unpacker unpacker(data, size);
+    bool ok = true;
+
+    const char *ptr = fmt.c_str();
+    const char *next;
+
+    while (ok and (next = std::strchr(ptr, '%')))
+    {
+        /* Literal text. */
+        stream.write(ptr, next - ptr);
+
+        Spec info = parse_spec(next);
+        ptr = info.end;
+
+        if (info.type == ArgType::invalid)
+        {
+            ok = false;
+            break;
+        }
+
+        std::string spec(info.start, info.end);
+        int32_t width = 0;
+        int32_t precision = 0;
+
+        if (info.star_width)
+        {
+            ok = unpacker.get(width);
+        }
+        if (ok and info.star_precision)
+        {
+            ok = unpacker.get(precision);
+        }
+        if (not ok)
+        {
+            break;
+        }
+
+        switch (info.type)
+        {
+        case ArgType::none:
+            stream << '%';
+            break;
+        case ArgType::int_arg:
+            ok = format_arg<int32_t, int>(unpacker, spec, info, width,
+                                          precision, stream);
+            break;
+        case ArgType::long_arg:
+        case ArgType::long_long_arg:
+        case ArgType::intmax_arg:
+        case ArgType::size_arg:
+        case ArgType::ptrdiff_arg:
+            /* Wider integers are all 64 bits on the wire. */
+            ok = format_arg<int64_t, long long>(
+                unpacker, with_modifier(info, "ll"), info, width, precision,
+                stream);
+            break;
+        case ArgType::double_arg:
+        case ArgType::long_double_arg:
+        {
+            uint64_t bits;
+            if ((ok = unpacker.get(bits)))
+            {
+                format_one(with_modifier(info, ""), info, width, precision,
+                           std::bit_cast<double>(bits), stream);
+            }
+            break;
+        }
+        case ArgType::string_arg:
+        {
+            std::string value;
+            if ((ok = unpacker.get_string(value)))
+            {
+                format_one(spec, info, width, precision, value.c_str(),
+                           stream);
+            }
+            break;
+        }
+        case ArgType::pointer_arg:
+        {
+            uint64_t address;
+            if ((ok = unpacker.get(address)))
+            {
+                format_one(spec, info, width, precision,
+                           reinterpret_cast<void *>(
+                               static_cast<uintptr_t>(address)),
+                           stream);
+            }
+            break;
+        }
+        case ArgType::count_arg:
+        case ArgType::invalid:
+            break;
+        }
+    }
+
+    if (ok)
+    {
+        /* Trailing literal text. */
+        stream << ptr;
+    }
+    else
+    {
+        stream << "<truncated>" << std::endl;
+    }
+
+    return ok;
+}
+
+std::size_t Decoder::decode(const uint8_t *data, std::size_t size,
+                            std::ostream &stream)
+{
+    if (size < sizeof(Header))
+    {
+        return 0;
+    }
+    Header header = Header::read(data);
+
+    std::size_t total = sizeof(Header) + header.length;
+    if (size < total)
+    {
+        return 0;
+    }
+
+    const uint8_t *payload = &data[sizeof(Header)];
+
+    switch (header.kind)
+    {
+    case format:
+        formats[header.id].assign(reinterpret_cast<const char *>(payload),
+                                  header.length);
+        break;
+
+    case arguments:
+    case truncated:
+    {
+        auto it = formats.find(header.id);
+        if (it != formats.end())
+        {
+            if (render(it->second, payload, header.length, stream) and
+                header.kind == truncated)
+            {
+                stream << "<truncated>" << std::endl;
+            }
+        }
+        else
+        {
+            stream << "<unknown format " << header.id << ">" << std::endl;
+        }
+        break;
+    }
+
+    default:
+        total = 0;
+    }
+
+    return total;
+}
+
+} // namespace Coral::BinaryLog
@@ -0,0 +1,113 @@
+/**
+ * \file
+ * \brief A compact binary log-record format (and offline decoder).
+ */
+#pragma once
+
+/* toolchain */
+#include <cstdarg>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace Coral::BinaryLog
+{
+
+/*
+ * Records don't depend on the host that wrote them: multi-byte fields are
+ * little endian, 'int' arguments (and '*' widths and precisions) are 32
+ * bits, other integers and pointers are 64 bits and floating-point values
+ * are IEEE 754 doubles (long doubles lose their extra precision).
+ */
+inline void store_le(uint8_t *data, uint64_t value, std::size_t bytes)
+{
+    for (std::size_t i = 0; i < bytes; i++)
+    {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint64_t load_le(const uint8_t *data, std::size_t bytes)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; i++)
+    {
+        value |= uint64_t(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+/*
+ * Every record starts with a header. A 'format' record defines a format
+ * string for an identifier (emitted once, the first time the string is
+ * used), and 'arguments' records carry packed printf arguments for a
+ * previously defined format ('truncated' when they didn't all fit).
+ */
+enum Kind : uint8_t
+{
+    format = 0,
+    arguments = 1,
+    truncated = 2,
+};
+
+struct [[gnu::packed]] Header
+{
+    uint8_t kind;
+    uint16_t id;
+    uint16_t length; /*!< Payload bytes following the header. */
+
+    inline void write(uint8_t *data) const
+    {
+        data[0] = kind;
+        store_le(&data[1], id, sizeof(id));
+        store_le(&data[3], length, sizeof(length));
+    }
+
+    static inline Header read(const uint8_t *data)
+    {
+        return {data[0], static_cast<uint16_t>(load_le(&data[1], 2)),
+                static_cast<uint16_t>(load_le(&data[3], 2))};
+    }
+};
+static_assert(sizeof(Header) == 5);
+
+/*
+ * Pack the arguments a printf-style format string consumes (no formatting is
+ * performed). Strings are stored as a 16-bit length followed by their
+ * contents. Packing stops early (and 'incomplete' is set) if the output is
+ * too small.
+ */
+std::size_t pack(const char *fmt, va_list args, uint8_t *data,
+                 std::size_t size, bool &incomplete);
+
+/*
+ * Reconstructs text from binary log records.
+ */
+class Decoder
+{
+  public:
+    Decoder() : formats()
+    {
+    }
+
+    /*
+     * Decode one record from the start of 'data', writing any text it
+     * produces to the stream. Returns the number of bytes consumed (zero if
+     * 'data' doesn't contain a complete, valid record).
+     */
+    std::size_t decode(const uint8_t *data, std::size_t size,
+                       std::ostream &stream = std::cout);
+
+    /*
+     * Render packed arguments with a format string. Returns false (after
+     * writing a marker) if the arguments were incomplete.
+     */
+    static bool render(const std::string &fmt, const uint8_t *data,
+                       std::size_t size, std::ostream &stream);
+
+  protected:
+    std::map<uint16_t, std::string> formats;
+};
+
+} // namespace Coral::BinaryLog
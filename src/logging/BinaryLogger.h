@@ -0,0 +1,166 @@
+/**
+ * \file
+ * \brief A logger that emits binary records instead of formatted text.
+ */
+#pragma once
+
+/* toolchain */
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/* internal */
+#include "../buffer/PcBuffer.h"
+#include "../buffer/cobs/Encoder.h"
+#include "BinaryLog.h"
+#include "LogInterface.h"
+
+namespace Coral
+{
+
+static constexpr std::size_t default_binary_depth = 512;
+static constexpr std::size_t default_max_formats = 256;
+
+/**
+ * A logger that writes a format-string identifier and packed arguments (see
+ * \ref BinaryLog) rather than formatting text at runtime. Each format string
+ * is emitted (once) as a definition record before its first use so that the
+ * output stream can be decoded offline without access to the program.
+ *
+ * Format strings are identified by address, so they must outlive the logger
+ * (string literals, as the logging macros use).
+ *
+ * \tparam Handler     Callable with signature
+ *                     void(const uint8_t *, std::size_t) receiving each
+ *                     complete record.
+ * \tparam depth       Maximum record size (header included).
+ * \tparam max_formats Maximum number of distinct format strings.
+ */
+template <class Handler, std::size_t depth = default_binary_depth,
+          std::size_t max_formats = default_max_formats>
+class BinaryLogger
+    : public LogInterface<BinaryLogger<Handler, depth, max_formats>>
+{
+    static_assert(depth > sizeof(BinaryLog::Header));
+    static_assert(max_formats > 0 and max_formats <= UINT16_MAX);
+
+    static constexpr std::size_t max_payload =
+        std::min<std::size_t>(depth - sizeof(BinaryLog::Header), UINT16_MAX);
+
+  public:
+    BinaryLogger(Handler _handler)
+        : handler(_handler), formats(), data(), truncated(0), dropped(0)
+    {
+    }
+
+    void vlog_impl(const char *fmt, va_list args)
+    {
+        uint16_t id;
+        if (not lookup(fmt, id))
+        {
+            dropped++;
+            return;
+        }
+
+        bool was_truncated;
+        std::size_t length =
+            BinaryLog::pack(fmt, args, &data[sizeof(BinaryLog::Header)],
+                            max_payload, was_truncated);
+        if (was_truncated)
+        {
+            truncated++;
+        }
+
+        emit((was_truncated) ? BinaryLog::truncated : BinaryLog::arguments,
+             id, length);
+    }
+
+    void poll_metrics(uint16_t &_truncated, uint16_t &_dropped,
+                      bool reset = true)
+    {
+        _truncated = truncated;
+        _dropped = dropped;
+        if (reset)
+        {
+            truncated = 0;
+            dropped = 0;
+        }
+    }
+
+  protected:
+    Handler handler;
+
+    /* Open-addressed table of format-string addresses (index is the id). */
+    std::array<const char *, max_formats> formats;
+
+    std::array<uint8_t, depth> data;
+
+    /* Metrics. */
+    uint16_t truncated;
+    uint16_t dropped;
+
+    void emit(BinaryLog::Kind kind, uint16_t id, std::size_t length)
+    {
+        BinaryLog::Header header = {kind, id, static_cast<uint16_t>(length)};
+        header.write(data.data());
+        handler(data.data(), sizeof(header) + length);
+    }
+
+    bool lookup(const char *fmt, uint16_t &id)
+    {
+        std::size_t index =
+            (reinterpret_cast<uintptr_t>(fmt) >> 3) % max_formats;
+
+        for (std::size_t i = 0; i < max_formats; i++)
+        {
+            auto &slot = formats[index];
+
+            if (slot == fmt)
+            {
+                id = index;
+                return true;
+            }
+
+            /* Define a new format (if it fits in a single record). */
+            if (slot == nullptr)
+            {
+                std::size_t length = std::strlen(fmt);
+                if (length > max_payload)
+                {
+                    return false;
+                }
+
+                slot = fmt;
+                id = index;
+
+                std::memcpy(&data[sizeof(BinaryLog::Header)], fmt, length);
+                emit(BinaryLog::format, id, length);
+                return true;
+            }
+
+            index = (index + 1) % max_formats;
+        }
+
+        return false;
+    }
+};
+
+/**
+ * Create a binary-logger handler that frames each record with COBS and
+ * writes it to a buffer. The buffer must be serviced (have a data-available
+ * callback) if records may not fit in the space available.
+ */
+template <std::size_t depth>
+inline auto cobs_log_handler(PcBuffer<depth, uint8_t> &buffer)
+{
+    return [&buffer](const uint8_t *data, std::size_t size) {
+        Cobs::MessageEncoder encoder(data, size);
+        while (not encoder.encode(buffer))
+        {
+            buffer.flush();
+        }
+    };
+}
+
+}; // namespace Coral
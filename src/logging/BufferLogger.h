@@ -6,11 +6,14 @@
 
 /* toolchain */
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <functional>
 #include <string>
+#include <string_view>
 
 /* internal */
+#include "../buffer/PcBuffer.h"
 #include "LogInterface.h"
 
 namespace Coral
@@ -41,4 +44,84 @@ class BufferLogger : public LogInterface<BufferLogger<depth>>
     std::array<element_t, depth> data;
 };
 
+/**
+ * A buffer logger that never allocates. Formatted messages are passed to the
+ * handler as a view into the internal buffer (only valid for the duration of
+ * the handler call).
+ *
+ * \tparam Handler Callable with signature void(std::string_view, bool), where
+ *                 the second argument indicates that the message was
+ *                 truncated to fit \p depth.
+ * \tparam depth   Size of the formatting buffer (including terminator).
+ */
+template <class Handler, std::size_t depth = default_buffer_depth>
+class ViewBufferLogger : public LogInterface<ViewBufferLogger<Handler, depth>>
+{
+    static_assert(depth > 1);
+
+  public:
+    using View = std::string_view;
+
+    ViewBufferLogger(Handler _handler)
+        : handler(_handler), data(), truncated(0), errors(0)
+    {
+    }
+
+    void vlog_impl(const char *fmt, va_list args)
+    {
+        int written = vsnprintf(data.data(), depth, fmt, args);
+
+        /* Encoding errors produce no output. */
+        if (written < 0)
+        {
+            errors++;
+            return;
+        }
+
+        /* The return value is the length the message would have had. */
+        std::size_t length = written;
+        bool was_truncated = length >= depth;
+        if (was_truncated)
+        {
+            length = depth - 1;
+            truncated++;
+        }
+
+        handler(View(data.data(), length), was_truncated);
+    }
+
+    void poll_metrics(uint16_t &_truncated, uint16_t &_errors,
+                      bool reset = true)
+    {
+        _truncated = truncated;
+        _errors = errors;
+        if (reset)
+        {
+            truncated = 0;
+            errors = 0;
+        }
+    }
+
+  protected:
+    Handler handler;
+    std::array<char, depth> data;
+
+    /* Metrics. */
+    uint16_t truncated;
+    uint16_t errors;
+};
+
+/*
+ * A ViewBufferLogger handler that writes messages to a buffer (servicing it
+ * while it's full).
+ */
+template <std::size_t depth>
+inline auto buffer_log_handler(PcBuffer<depth, char> &buffer)
+{
+    return [&buffer](std::string_view message, bool truncated) {
+        (void)truncated;
+        buffer.push_n_blocking(message.data(), message.size());
+    };
+}
+
 }; // namespace Coral